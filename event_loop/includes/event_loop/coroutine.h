@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "types.h"
+
+// C++20 coroutines on top of EventLoop, only available when the compiler supports them.
+#ifdef FT_HAS_COROUTINE
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "event_channel.h"
+#include "event_loop.h"
+#include "loop_future.h"
+
+namespace FT {
+class SleepAwaiter {
+public:
+    SleepAwaiter(EventLoop *loop, TimeType delay) noexcept : loop_(loop), delay_(delay) {}
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        loop_->RunAfter([handle]() { handle.resume(); }, delay_);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop *loop_ = nullptr;
+    TimeType delay_ = 0;
+};
+
+class SwitchToAwaiter {
+public:
+    explicit SwitchToAwaiter(EventLoop *loop) noexcept : loop_(loop) {}
+
+    bool await_ready() const
+    {
+        return loop_->IsInLoopThread();
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        loop_->QueueToLoop([handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop *loop_ = nullptr;
+};
+
+// Borrows the channel's read callback until the fd becomes readable, then gives it back and
+// resumes the coroutine with the poll time. The channel listens for reading only while it waits
+// if it did not already. The coroutine must not be destroyed while it waits.
+// Only for the level-triggered channels, the read callback of an edge-triggered one is never called.
+class ReadableAwaiter {
+public:
+    explicit ReadableAwaiter(EventChannel *channel) noexcept : channel_(channel) {}
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        channel_->AssertInLoopThread();
+        handle_ = handle;
+        prevCallback_ = std::move(channel_->readCallback_);
+        wasReading_ = channel_->IsReading();
+        channel_->readCallback_ = [this](TimeStamp receivedTime) { OnReadable(receivedTime); };
+        if (!wasReading_) {
+            channel_->EnableReading();
+        }
+    }
+    TimeStamp await_resume() const noexcept
+    {
+        return receivedTime_;
+    }
+
+private:
+    void OnReadable(TimeStamp receivedTime)
+    {
+        receivedTime_ = receivedTime;
+        // this destroys the lambda which called us, nothing captured by it is used after this.
+        channel_->readCallback_ = std::move(prevCallback_);
+        if (!wasReading_) {
+            channel_->DisableReading();
+        }
+        // resume after HandleEvent returns, the coroutine may destroy the channel.
+        channel_->GetOwnerLoop()->QueueToLoop([handle(handle_)]() { handle.resume(); });
+    }
+
+    EventChannel *channel_ = nullptr;
+    std::coroutine_handle<> handle_;
+    ReadCallback prevCallback_;
+    bool wasReading_ = false;
+    TimeStamp receivedTime_;
+};
+
+inline SleepAwaiter EventLoop::Sleep(TimeType delay)
+{
+    return SleepAwaiter(this, delay);
+}
+
+inline SwitchToAwaiter EventLoop::SwitchTo()
+{
+    return SwitchToAwaiter(this);
+}
+
+inline ReadableAwaiter EventChannel::Readable()
+{
+    return ReadableAwaiter(this);
+}
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+class TaskPromiseBase {
+public:
+    struct FinalAwaiter {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            return handle.promise().Complete(handle);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+    void unhandled_exception() const noexcept
+    {
+        std::terminate();
+    }
+
+    void SetContinuation(std::coroutine_handle<> continuation, EventLoop *loop) noexcept
+    {
+        continuation_ = continuation;
+        continuationLoop_ = loop;
+    }
+    void SetDetached() noexcept
+    {
+        detached_ = true;
+    }
+
+private:
+    // pick what runs after the task finished, the task's frame must not be touched after this.
+    std::coroutine_handle<> Complete(std::coroutine_handle<> self) noexcept
+    {
+        if (detached_) {
+            self.destroy();
+            return std::noop_coroutine();
+        }
+        if (!continuation_) {
+            return std::noop_coroutine();
+        }
+        if (continuationLoop_ == nullptr || continuationLoop_->IsInLoopThread()) {
+            return continuation_;
+        }
+        // the task moved to another loop, go back to the awaiter's one.
+        continuationLoop_->QueueToLoop([continuation(continuation_)]() { continuation.resume(); });
+        return std::noop_coroutine();
+    }
+
+    std::coroutine_handle<> continuation_;
+    EventLoop *continuationLoop_ = nullptr; // the loop of the awaiting coroutine.
+    bool detached_ = false;
+};
+
+template <typename T>
+class TaskPromise final : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename Value>
+    void return_value(Value &&value)
+    {
+        result_.emplace(std::forward<Value>(value));
+    }
+
+    T TakeResult()
+    {
+        return std::move(*result_);
+    }
+
+private:
+    std::optional<T> result_;
+};
+
+template <>
+class TaskPromise<void> final : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+    void TakeResult() const noexcept {}
+};
+} // namespace detail
+
+// Lazy coroutine task: it starts when awaited or spawned.
+// co_await task runs it at once in the awaiting thread, and if the task moved to another loop
+// (by SwitchTo or an awaitable of another loop), the awaiting coroutine still resumes in its own loop.
+// Exceptions are not supported, an exception leaving the task terminates the process.
+template <typename T>
+class Task : NonCopyable {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class Awaiter {
+    public:
+        explicit Awaiter(Handle handle) noexcept : handle_(handle) {}
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().SetContinuation(awaiting, EventLoop::EventLoopOfCurrThread());
+            return handle_;
+        }
+        T await_resume()
+        {
+            return handle_.promise().TakeResult();
+        }
+
+    private:
+        Handle handle_;
+    };
+
+    Task() noexcept = default;
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~Task() noexcept
+    {
+        Reset();
+    }
+
+    bool Valid() const noexcept
+    {
+        return static_cast<bool>(handle_);
+    }
+
+    Awaiter operator co_await() && noexcept
+    {
+        return Awaiter(handle_);
+    }
+
+    // start the task in @loop without awaiting it, its frame is released when it finishes.
+    void Detach(EventLoop *loop) &&
+    {
+        Handle handle = std::exchange(handle_, nullptr);
+        handle.promise().SetDetached();
+        loop->RunInLoop([handle]() { handle.resume(); });
+    }
+
+private:
+    void Reset() noexcept
+    {
+        if (handle_) {
+            std::exchange(handle_, nullptr).destroy();
+        }
+    }
+
+    Handle handle_;
+};
+
+namespace detail {
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+template <typename T>
+Task<void> RunToFuture(Task<T> task, PromiseRef<LoopFutureState<T>> state)
+{
+    if constexpr (std::is_void_v<T>) {
+        co_await std::move(task);
+        state->SetResult(VoidResult());
+    } else {
+        state->SetResult(co_await std::move(task));
+    }
+}
+} // namespace detail
+
+// start @task in @loop, the returned future gets its result and may be dropped.
+// the loop must outlive the task.
+template <typename T>
+LoopFuture<T> Spawn(EventLoop *loop, Task<T> task)
+{
+    auto state = new detail::LoopFutureState<T>();
+    state->AddRef(); // one for the future, one for the task.
+    detail::RunToFuture(std::move(task), detail::PromiseRef<detail::LoopFutureState<T>>(state)).Detach(loop);
+    return LoopFuture<T>(state);
+}
+} // namespace FT
+#endif // FT_HAS_COROUTINE
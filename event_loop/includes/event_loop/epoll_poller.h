@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "unique_fd.h"
+#include "event_poller.h"
+
+namespace FT {
+// Registers every channel with a generation-tagged index into a flat slab of slots in epoll_event.data,
+// so a ready event is dispatched without any hash lookup, and an event of a slot which was released
+// (and maybe reused by another fd) since the registration is detected and dropped by PollOnce.
+// The channels removed later, by a callback of the same batch, are dropped by EventLoop::RemoveChannel.
+class EpollPoller : public EventPoller {
+public:
+    explicit EpollPoller(EventLoop *eventLoop);
+    ~EpollPoller() noexcept override;
+
+    TimeStamp PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs) override;
+    void UpdateChannel(EventChannel *channel) override;
+    void RemoveChannel(int fd) override;
+
+    PollerBackend Backend() const override
+    {
+        return PollerBackend::EPOLL;
+    }
+
+private:
+    struct Slot {
+        EventChannel *channel = nullptr;
+        uint32_t generation = 0; // bumped when the slot is released.
+    };
+
+    static uint64_t MakeTag(uint32_t slot, uint32_t generation);
+    uint32_t AllocSlot(EventChannel *channel);
+    void ReleaseSlot(uint32_t slot);
+    void EpollCtl(int fd, uint32_t events, uint64_t tag, int operation);
+
+    static constexpr std::size_t INIT_EVENT_SIZE = 32;
+    OHOS::UniqueFd epollFd_;
+    std::size_t eventSize_ = INIT_EVENT_SIZE; // per poller, grows when epoll_wait fills the buffer.
+    std::vector<epoll_event> activeEvents_; // to receive events from epoll_wait.
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+    std::unordered_map<int, uint32_t> fdSlots_; // only used by the registration changes, not by the dispatch.
+};
+} // namespace FT
@@ -16,20 +16,30 @@
 #pragma once
 
 #include <atomic>
-#include <functional>
 #include <memory>
 #include <mutex>
 #include <sys/epoll.h>
 
 #include "noncopyable_hal.h"
 #include "timestamp.h"
+#include "unique_function.h"
 
 namespace FT {
-using EventCallback = std::function<void()>;
-using ReadCallback = std::function<void(TimeStamp)>;
+using EventCallback = UniqueFunction<void()>;
+using ReadCallback = UniqueFunction<void(TimeStamp)>;
+
+// result of one call of an EdgeReadCallback.
+enum class ReadStatus {
+    MORE,    // consumed some input, there may be more.
+    DRAINED, // the fd returned EAGAIN, wait for the next edge.
+};
+using EdgeReadCallback = UniqueFunction<ReadStatus(TimeStamp)>;
 
 class EventPoller;
 class EventLoop;
+#ifdef FT_HAS_COROUTINE
+class ReadableAwaiter; // defined in coroutine.h.
+#endif
 
 // use EPOLL_EVENTS to define channel event types.
 enum class EventType : uint32_t {
@@ -62,6 +72,11 @@ public:
     {
         readCallback_ = std::move(cb);
     }
+    // Listen edge-triggered, and call @cb in a loop until it returns DRAINED on each read event.
+    // @budget: most calls of @cb per dispatch, 0 for no limit. When it runs out, the channel is
+    // dispatched again in the next iteration without waiting for another edge, so a hot fd can't
+    // starve the others. Replaces the read callback. not thread safe.
+    void SetEdgeReadCallback(EdgeReadCallback cb, std::size_t budget = 0);
     // not thread safe.
     void SetWriteCallback(EventCallback cb)
     {
@@ -78,6 +93,12 @@ public:
         closeCallback_ = std::move(cb);
     }
 
+#ifdef FT_HAS_COROUTINE
+    // co_await channel.Readable() resumes the coroutine in the owner loop once the fd is readable,
+    // it takes over the read callback until then. Must be called in the loop thread.
+    ReadableAwaiter Readable();
+#endif
+
     bool HasNoEvent() const
     {
         return ListeningEvents() == ECast(EventType::NONE);
@@ -90,6 +111,10 @@ public:
     {
         return ListeningEvents() & ECast(EventType::READ_EVENT);
     }
+    bool IsEdgeTriggered() const
+    {
+        return ListeningEvents() & ECast(EventType::EDGE_EVENT);
+    }
 
     // @toUpdate: whether to update the channel in poller or not, true by default.
     void EnableReading(bool toUpdate = true);
@@ -118,8 +143,13 @@ protected:
     void AssertInLoopThread() const;
 
     void HandleEventInner(TimeStamp receivedTime);
+    void HandleEdgeRead(TimeStamp receivedTime);
 
     friend class EventPoller;
+    friend class EventLoop; // dispatches the requeued edge-triggered channels.
+#ifdef FT_HAS_COROUTINE
+    friend class ReadableAwaiter;
+#endif
     uint32_t ListeningEvents() const
     {
         return listeningEvents_;
@@ -127,6 +157,18 @@ protected:
     void SetReceivedEvents(uint32_t events)
     {
         receivedEvents_ = events;
+        // a new edge dispatches the requeued read as well.
+        readRequeued_ = false;
+    }
+    // @return: whether the requeued read is still due, and marks the channel readable if so.
+    bool TakeRequeuedRead()
+    {
+        if (!readRequeued_) {
+            return false;
+        }
+        readRequeued_ = false;
+        receivedEvents_ = EPOLLIN;
+        return true;
     }
 
     int fd_ = -1;
@@ -137,6 +179,9 @@ protected:
     uint32_t receivedEvents_ = ECast(EventType::NONE);
 
     ReadCallback readCallback_;
+    EdgeReadCallback edgeReadCallback_;
+    std::size_t edgeReadBudget_ = 0;
+    bool readRequeued_ = false;
     EventCallback writeCallback_;
     EventCallback errorCallback_;
     EventCallback closeCallback_;
@@ -15,79 +15,186 @@
 
 #pragma once
 
-#include <future>
+#include <array>
+#include <deque>
 #include <type_traits>
 
 #include "event_poller.h"
+#include "loop_future.h"
+#include "loop_stats.h"
+#include "loop_watchdog.h"
+#include "mpsc_queue.h"
 #include "timer_queue.h"
+#include "work_stealing_executor.h"
 
 namespace FT {
-using Functor = std::function<void()>;
+using Functor = UniqueFunction<void()>;
 
-namespace detail {
-template <typename Callable>
-class PackagedTask : NonCopyable {
-    using Return = std::invoke_result_t<Callable>;
+#ifdef FT_HAS_COROUTINE
+// awaitables of EventLoop::Sleep and EventLoop::SwitchTo, defined in coroutine.h.
+class SleepAwaiter;
+class SwitchToAwaiter;
+#endif
 
-public:
-    ~PackagedTask() noexcept = default;
-
-    static auto Create(Callable &&cb)
-    {
-        std::shared_ptr<PackagedTask<Callable>> t(new PackagedTask(std::forward<Callable &&>(cb)));
-        return std::make_pair(t, t->cb_.get_future());
-    }
+// counters of the eventfd writes done by EventLoop::WakeUp.
+struct WakeUpStats {
+    uint64_t issued = 0;     // wakeups which really wrote the eventfd.
+    uint64_t suppressed = 0; // wakeups skipped because one was already pending, or the loop was spinning.
+    uint64_t busyPolled = 0; // spins which found work before falling back to a blocking poll.
+    uint64_t busyPollMisses = 0; // spins which found nothing.
+};
 
-    void Run()
-    {
-        cb_();
-    }
+// lanes of the pending functors, the higher lanes are drained first in every iteration.
+enum class FunctorPriority : uint32_t {
+    INPUT = 0,      // input events, delivered before anything else.
+    PROTOCOL = 1,   // the default one, the usual requests and events.
+    RENDER = 2,     // compose and other window work.
+    BACKGROUND = 3, // work which can wait, bounded by a time budget by default.
+};
+constexpr std::size_t FUNCTOR_PRIORITY_NUM = 4;
 
-private:
-    explicit PackagedTask(Callable &&cb) : cb_(std::move(cb)) {}
+// how much of a functor lane is drained in one iteration, the rest waits for the next one,
+// which polls without blocking. By default every lane drains all the functors queued before
+// the drain (strict priority), limiting the count of the lanes makes the draining weighted.
+struct FunctorLaneOptions {
+    std::size_t maxPerIteration = 0; // 0 for no limit.
+    TimeType budget = 0;             // micro seconds, checked after each functor, 0 for no limit.
+};
 
-    std::packaged_task<Return()> cb_;
+// options to construct an EventLoop.
+struct EventLoopOptions {
+    PollerBackend pollerBackend = PollerBackend::EPOLL;
+    TimerQueueBackend timerQueueBackend = TimerQueueBackend::ORDERED_SET;
+    // executor of EventLoop::Offload, null means WorkStealingExecutor::GetDefault().
+    std::shared_ptr<WorkStealingExecutor> offloadExecutor;
+    // record the latencies of every iteration, see EventLoop::GetLoopStats.
+    bool enableLoopStats = true;
+    // start a LoopWatchdog reporting the iterations longer than this (micro seconds), 0 for none.
+    TimeType stallBudget = 0;
+    // indexed by FunctorPriority, the background lane yields to the poller after 2ms by default.
+    std::array<FunctorLaneOptions, FUNCTOR_PRIORITY_NUM> functorLanes = {
+        FunctorLaneOptions(), FunctorLaneOptions(), FunctorLaneOptions(), FunctorLaneOptions{0, 2000}};
+    // longest spin (micro seconds) polling without blocking before each blocking poll, 0 for none.
+    // The spin adapts like the kernel's halt polling: it grows while the loop is woken up soon
+    // after it blocks, and shrinks while it stays blocked longer than this. Producers skip the
+    // eventfd write while the loop spins. Burns a core, only for loops with a dedicated one.
+    TimeType busyPollWindow = 0;
 };
-} // namespace detail
 
 class EventLoop : NonCopyable {
 public:
     EventLoop();
+    explicit EventLoop(const EventLoopOptions &options);
     ~EventLoop() noexcept;
+    // run the iterations until Stop(), at once if it was already called.
     void Start();
+    // can be called from any thread, even before Start().
     void Stop() noexcept;
     void UpdateChannel(EventChannel *channel);
     void RemoveChannel(int channelFd);
+    // dispatch the read of the edge-triggered @channel again in the next iteration,
+    // for the channels which stopped before draining their fd. must be called in the loop thread.
+    void RequeueChannel(EventChannel *channel);
 
+    // run @task in the loop, the returned future gets its result.
     template <typename Task, typename Ret = std::invoke_result_t<Task>>
-    std::future<Ret> Schedule(Task task)
+    LoopFuture<Ret> Schedule(Task task)
+    {
+        using State = detail::ScheduledTaskState<Ret, Task>;
+        auto state = new State(std::move(task));
+        state->AddRef(); // one for the future, one for the functor.
+        RunInLoop([ref(detail::PromiseRef<State>(state))]() { ref->Run(); });
+        return LoopFuture<Ret>(state);
+    }
+
+    // run @task in the offload executor, then run @then(result) in this loop through QueueToLoop.
+    // @then takes no argument if @task returns void.
+    // can be called from any thread, the loop must outlive the task.
+    template <typename Task, typename Then>
+    void Offload(Task task, Then then)
     {
-        auto [packagedTask, future] = detail::PackagedTask<Task>::Create(std::move(task));
-        RunInLoop([t(std::move(packagedTask))]() { t->Run(); });
-        return std::move(future);
+        OffloadExecutor().Submit([this, task(std::move(task)), then(std::move(then))]() mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<Task>>) {
+                task();
+                QueueToLoop(std::move(then));
+            } else {
+                QueueToLoop([then(std::move(then)), result(task())]() mutable { then(std::move(result)); });
+            }
+        });
     }
 
     // run func immediately if in loop thread, or call queueToLoop() if in other thread.
-    void RunInLoop(Functor func);
+    void RunInLoop(Functor func, FunctorPriority priority = FunctorPriority::PROTOCOL);
 
-    // add this func to the last of the loop's pending functors.
-    void QueueToLoop(Functor func);
+    // add this func to the last of the loop's pending functors of @priority.
+    void QueueToLoop(Functor func, FunctorPriority priority = FunctorPriority::PROTOCOL);
 
-    TimerId RunAt(Functor func, TimeStamp dstTime);
+    // slack in micro seconds, how late the timer may run so that it shares a wakeup with the
+    // other timers, see TimerQueue::AddTimer. 0 means run as soon as it expires.
+    TimerId RunAt(Functor func, TimeStamp dstTime, TimeType slack = 0);
 
     // delay in micro seconds, 0 means run immediately
-    TimerId RunAfter(Functor func, TimeType delay);
+    TimerId RunAfter(Functor func, TimeType delay, TimeType slack = 0);
 
     // delay in micro seconds, 0 means run immediately
     // interval in micro seconds, 0 means only run once.
-    TimerId RunEvery(Functor func, TimeType interval, TimeType delay = 0);
+    TimerId RunEvery(Functor func, TimeType interval, TimeType delay = 0, TimeType slack = 0);
 
     void Cancel(const TimerId &timerId);
 
+    // the loop's clock, refreshed once after every poll, so everything done in an iteration shares one
+    // monotonic time without reading the clock again. RunAt/RunAfter/RunEvery count from it, so a timer
+    // armed late in a long iteration fires that much earlier. other threads get TimeStamp::Now().
+    TimeStamp Now() const;
+    // read the clock, and refresh the loop's clock with it in the loop thread.
+    TimeStamp NowPrecise();
+
+    // run @hook at the end of every iteration, right before the loop polls (and maybe sleeps) again,
+    // to batch the work done by the iteration, like flushing the output buffered by it.
+    // The hooks must not queue functors nor add idle tasks, the poll after them may block.
+    // can be called from any thread.
+    void AddPreSleepHook(Functor hook);
+
+    // run @task in an idle iteration: one which found no ready channel (nor expired timer)
+    // and executed no functor above FunctorPriority::BACKGROUND.
+    // @deadline: longest deferral in micro seconds, the task runs after it even if the loop is
+    // never idle. 0 for no limit.
+    // can be called from any thread. While idle tasks are waiting, the poll blocks for 1ms at most (less if
+    // a deadline is closer), and a poll which times out makes the iteration idle.
+    void RunWhenIdle(Functor task, TimeType deadline = 0);
+
+#ifdef FT_HAS_COROUTINE
+    // co_await loop.Sleep(delay) resumes the coroutine in this loop after @delay micro seconds.
+    SleepAwaiter Sleep(TimeType delay);
+    // co_await loop.SwitchTo() resumes the coroutine in this loop, at once if it already runs here.
+    SwitchToAwaiter SwitchTo();
+#endif
+
     static EventLoop *EventLoopOfCurrThread();
 
     bool IsInLoopThread() const;
 
+    // can be called from any thread.
+    WakeUpStats GetWakeUpStats() const;
+    // can be called from any thread.
+    TimerStats GetTimerStats() const;
+
+    // number of functors queued but not executed yet, used as the load of this loop.
+    // can be called from any thread, the result is only a hint.
+    std::size_t PendingFunctorCount() const;
+
+    // latencies of poll, dispatch, timers and functors of this loop, all zero if they are disabled
+    // by EventLoopOptions::enableLoopStats. can be called from any thread.
+    const LoopStats &GetLoopStats() const;
+    // clear the latencies, done in the loop thread. can be called from any thread.
+    void ResetLoopStats();
+
+    // stalls reported by the watchdog, all zero if EventLoopOptions::stallBudget is 0.
+    // can be called from any thread.
+    StallStats GetStallStats() const;
+    // append the watchdog's stall stats to @out, nothing if there is no watchdog.
+    void DumpStallStats(std::string &out) const;
+
     // will abort if not in loop thread.
     void AssertInLoopThread() const;
     // will abort if in loop thread.
@@ -97,21 +204,103 @@ private:
     void WakeUp();
     void WakeUpCallback();
 
-    void ExecPendingFunctors();
+    // @return: number of functors executed above FunctorPriority::BACKGROUND.
+    std::size_t ExecPendingFunctors();
+    void AddIdleTask(Functor &&task, TimeStamp deadline);
+    // @idle: whether this iteration is idle, only the overdue tasks run if not.
+    void RunIdleTasks(bool idle);
+    void RunOverdueIdleTasks(TimeStamp now);
+    // timeout of the poll while idle tasks are waiting.
+    int IdlePollTimeoutMs() const;
+    void DispatchActiveChannels(TimeStamp pollTime);
+    void MergeRequeuedChannels();
+    // spin polling without blocking for the current busy poll window.
+    // @return: whether it found ready channels or functors, with the poll time in @pollTime.
+    bool BusyPoll(TimeStamp &pollTime);
+    // resize the busy poll window by how long the last blocking poll waited.
+    void AdaptBusyPoll(uint64_t blockedNanos);
+
+    // cycles to time the stats with, 0 if the stats are disabled.
+    uint64_t StatsCycles() const
+    {
+        return statsEnabled_ ? detail::ReadCycles() : 0;
+    }
+
+    WorkStealingExecutor &OffloadExecutor() const;
+
+    // node of the lock-free pending functor queue.
+    struct PendingFunctor : MpscQueueNode {
+        explicit PendingFunctor(Functor &&f) : func(std::move(f)) {}
+        Functor func;
+        PendingFunctor *nextFree = nullptr;
+        uint64_t enqueueCycles = 0; // when it was queued, for the queue delay stats.
+    };
+
+    // the functors queued in the loop thread reuse the nodes of the executed ones,
+    // the ones queued by other threads still allocate a node each.
+    PendingFunctor *AcquireFunctorNode(Functor &&func);
+    void RecycleFunctorNode(PendingFunctor *node);
 
     ThreadId tid_ = -1; // indicates which thread is this loop in.
 
-    mutable std::mutex mutex_;
-    std::atomic<bool> running_{false};
+    // set by Stop() and never cleared, so a Stop() which comes before Start() is not lost.
+    std::atomic<bool> quit_{false};
 
     std::unique_ptr<EventPoller> poller_;
+    std::vector<EventChannel *> activeChannels_; // reused by every iteration.
+    // activeChannels_ from this index on are not dispatched yet, RemoveChannel clears them there, so that
+    // a channel removed (and maybe destroyed) by an earlier callback of the same batch is skipped.
+    std::size_t undispatchedIndex_ = 0;
+    TimeStamp loopNow_;                          // the time of the last poll, see Now().
+    // edge-triggered channels to dispatch in the next iteration, with their fd to drop them by RemoveChannel.
+    std::vector<std::pair<int, EventChannel *>> requeuedChannels_;
 
     OHOS::UniqueFd wakeUpFd_;
     std::unique_ptr<EventChannel> wakeUpChannel_;
+    // set by the first WakeUp after a drain, cleared by WakeUpCallback.
+    std::atomic<bool> wakeUpPending_{false};
+    std::atomic<uint64_t> wakeUpsIssued_{0};
+    std::atomic<uint64_t> wakeUpsSuppressed_{0};
+
+    uint64_t busyPollMaxNanos_ = 0;    // 0 if busy polling is disabled.
+    uint64_t busyPollWindowNanos_ = 0; // the current spin, adapted by AdaptBusyPoll.
+    std::atomic<uint64_t> busyPolled_{0};
+    std::atomic<uint64_t> busyPollMisses_{0};
+
+    struct FunctorLane {
+        MpscQueue<PendingFunctor> functors;
+        std::size_t maxPerIteration = 0;
+        uint64_t budgetNanos = 0;
+    };
+    // @return: number of functors executed, sets functorsLeft_ if it stops before @batchEnd.
+    std::size_t ExecFunctorLane(FunctorLane &lane, MpscQueueNode *batchEnd);
 
     std::atomic<bool> executingPendingFunctors_{false};
-    std::vector<Functor> pendingFunctors_;
+    std::array<FunctorLane, FUNCTOR_PRIORITY_NUM> functorLanes_;
+    bool functorsLeft_ = false; // a lane stopped early, so do not block in the next poll.
+    std::atomic<std::size_t> pendingFunctorCount_{0};
+    static constexpr std::size_t MAX_FREE_FUNCTOR_NODES = 256;
+    PendingFunctor *freeFunctorNodes_ = nullptr; // only touched in the loop thread.
+    std::size_t freeFunctorNodeCount_ = 0;
+
+    bool statsEnabled_ = true;
+    LoopStats stats_;
 
     std::unique_ptr<TimerQueue> timerQueue_;
+
+    struct IdleTask {
+        Functor func;
+        TimeStamp deadline;
+    };
+    std::deque<IdleTask> idleTasks_;   // only touched in the loop thread.
+    TimeStamp nextIdleDeadline_;       // no later than the earliest deadline of idleTasks_.
+    std::vector<Functor> overdueIdleTasks_; // reused by RunOverdueIdleTasks.
+
+    std::vector<Functor> preSleepHooks_; // only touched in the loop thread.
+
+    LoopHeartbeat heartbeat_;
+    std::unique_ptr<LoopWatchdog> watchdog_; // null if no stall budget is set.
+
+    std::shared_ptr<WorkStealingExecutor> offloadExecutor_;
 };
 } // namespace FT
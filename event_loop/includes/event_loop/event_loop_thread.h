@@ -20,12 +20,17 @@
 #include <thread>
 
 #include "event_loop.h"
+#include "thread_options.h"
 
 namespace FT {
 class EventLoopThread : NonCopyable {
 public:
     EventLoopThread();
     explicit EventLoopThread(std::string name);
+    // @options: options to construct the EventLoop in the thread.
+    // @threadOptions: affinity, scheduling and memory policy of the thread, which is also named @name.
+    EventLoopThread(std::string name, const EventLoopOptions &options,
+        const ThreadOptions &threadOptions = ThreadOptions());
     ~EventLoopThread() noexcept;
 
     EventLoop *Start();
@@ -40,6 +45,8 @@ private:
     mutable std::mutex mutex_;
     std::condition_variable cond_;
     std::string name_;
+    EventLoopOptions options_;
+    ThreadOptions threadOptions_;
     std::thread thread_;
     EventLoop *loop_ = nullptr;
 };
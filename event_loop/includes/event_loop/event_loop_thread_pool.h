@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "event_loop_thread.h"
+
+namespace FT {
+// how EventLoopThreadPool::GetNextLoop picks a loop.
+enum class LoopSelectPolicy {
+    ROUND_ROBIN,  // cycle through the loops.
+    LEAST_LOADED, // the loop with the fewest pending functors, ties are broken round robin.
+};
+
+// A fixed set of EventLoopThreads, each loop owns its own poller, timers and functor queue.
+// Start() must be called once before getting any loop, the getters can then be called from any thread.
+class EventLoopThreadPool : NonCopyable {
+public:
+    // @name: prefix of the threads' name, the threads are named "<name>-<index>".
+    // @threadNum: number of loops, must be greater than 0.
+    // @options: options to construct every EventLoop of this pool.
+    // @threadOptions: options of every thread, see ThreadOptions::spreadCpus.
+    EventLoopThreadPool(std::string name, std::size_t threadNum, const EventLoopOptions &options = EventLoopOptions(),
+        const ThreadOptions &threadOptions = ThreadOptions());
+    ~EventLoopThreadPool() noexcept;
+
+    // start all the threads and wait until their loops are constructed.
+    void Start();
+    bool Started() const
+    {
+        return started_;
+    }
+
+    EventLoop *GetNextLoop(LoopSelectPolicy policy = LoopSelectPolicy::ROUND_ROBIN);
+
+    // always returns the same loop for the same hash, to pin related work to one thread.
+    EventLoop *GetLoopForHash(std::size_t hash) const;
+
+    const std::vector<EventLoop *> &GetAllLoops() const
+    {
+        return loops_;
+    }
+
+    std::size_t Size() const
+    {
+        return threadNum_;
+    }
+
+    const std::string &Name() const
+    {
+        return name_;
+    }
+
+private:
+    EventLoop *GetLeastLoadedLoop();
+
+    std::string name_;
+    std::size_t threadNum_ = 0;
+    EventLoopOptions options_;
+    ThreadOptions threadOptions_;
+    std::atomic<bool> started_{false};
+    std::vector<std::unique_ptr<EventLoopThread>> threads_;
+    std::vector<EventLoop *> loops_;
+    std::atomic<std::size_t> next_{0};
+};
+} // namespace FT
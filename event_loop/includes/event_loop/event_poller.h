@@ -15,32 +15,54 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
 #include <vector>
 
-#include "unique_fd.h"
 #include "event_channel.h"
 
 namespace FT {
 class EventLoop;
 
+// the I/O multiplexing mechanism of an EventPoller.
+enum class PollerBackend {
+    EPOLL,
+    // poll requests on an io_uring, registration changes are submitted in batch with the wait of
+    // the next PollOnce. Falls back to EPOLL if the kernel does not support it.
+    // The level-triggered channels get a single-shot poll, armed again after each completion, so they
+    // are reported as long as they are ready, like with epoll. The edge-triggered ones get a multishot
+    // poll, which only reports new wakeups. A reported readiness may already be stale, so the fds must
+    // be nonblocking.
+    IO_URING,
+};
+
+// Interface of the pollers which wait for the EventChannels of one EventLoop,
+// all the functions must be called in the loop thread.
 class EventPoller : NonCopyable {
 public:
-    explicit EventPoller(EventLoop *eventLoop);
-    ~EventPoller() noexcept;
+    virtual ~EventPoller() noexcept = default;
+
+    // @return: the poller of @backend, or an epoll one if @backend is not supported.
+    static std::unique_ptr<EventPoller> Create(EventLoop *eventLoop, PollerBackend backend);
 
-    TimeStamp PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs);
-    void UpdateChannel(EventChannel *channel);
-    void RemoveChannel(int fd);
+    virtual TimeStamp PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs) = 0;
+    virtual void UpdateChannel(EventChannel *channel) = 0;
+    virtual void RemoveChannel(int fd) = 0;
+
+    virtual PollerBackend Backend() const = 0;
+
+protected:
+    explicit EventPoller(EventLoop *eventLoop);
 
-private:
-    void AssertInLoopThread();
+    // the EventChannel's private accessors, friendship is not inherited by the backends.
+    static uint32_t ListeningEvents(const EventChannel *channel)
+    {
+        return channel->ListeningEvents();
+    }
+    static void SetReceivedEvents(EventChannel *channel, uint32_t events)
+    {
+        channel->SetReceivedEvents(events);
+    }
 
-    void EpollCtl(EventChannel *channel, int operation);
     EventLoop *eventLoop_ = nullptr;
-    OHOS::UniqueFd epollFd_;
-    static std::size_t eventSize_;
-    std::vector<epoll_event> activeEvents_; // to receive events from epoll_wait.
-    std::unordered_map<int, EventChannel *> channels_;
 };
 } // namespace FT
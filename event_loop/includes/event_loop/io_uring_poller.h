@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <unordered_map>
+#include <vector>
+
+#include "unique_fd.h"
+#include "event_poller.h"
+
+namespace FT {
+// EventPoller on io_uring, using the raw syscalls so that it does not depend on liburing.
+// Every listening channel has an IORING_OP_POLL_ADD request in flight, whose user_data carries the fd
+// and a generation number, so the completions of an updated or removed registration are recognized and
+// dropped. The request is single-shot for a level-triggered channel: it is armed again when it completes,
+// and that is submitted with the next wait, after the channel handled the event, so a channel which is
+// still ready completes again at once. An edge-triggered channel (EPOLLET) gets a multishot request.
+// Update/Remove only queue SQEs, they are all submitted by the io_uring_enter which waits in the next PollOnce.
+// Unlike epoll_wait, a reported readiness may be stale, so the channels' fds must be nonblocking.
+class IoUringPoller : public EventPoller {
+public:
+    explicit IoUringPoller(EventLoop *eventLoop);
+    ~IoUringPoller() noexcept override;
+
+    // @return: nullptr if the kernel does not support everything this poller needs
+    // (multishot poll and timed waits, linux 5.13+), or the ring can't be created.
+    static std::unique_ptr<IoUringPoller> TryCreate(EventLoop *eventLoop);
+
+    TimeStamp PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs) override;
+    void UpdateChannel(EventChannel *channel) override;
+    void RemoveChannel(int fd) override;
+
+    PollerBackend Backend() const override
+    {
+        return PollerBackend::IO_URING;
+    }
+
+private:
+    struct Registration {
+        EventChannel *channel = nullptr;
+        uint32_t generation = 0;
+        uint32_t events = 0;
+        bool armed = false;
+        uint64_t lastActivePoll = 0; // the PollOnce which reported it last, to report it once per poll.
+        uint32_t receivedEvents = 0; // merged events of the completions of lastActivePoll.
+    };
+
+    // the mmapped rings of the kernel.
+    struct SubmissionQueue {
+        unsigned *head = nullptr;
+        unsigned *tail = nullptr;
+        unsigned *ringMask = nullptr;
+        unsigned *array = nullptr;
+        io_uring_sqe *sqes = nullptr;
+        unsigned pendingTail = 0; // our tail, published to the kernel right before io_uring_enter.
+    };
+    struct CompletionQueue {
+        unsigned *head = nullptr;
+        unsigned *tail = nullptr;
+        unsigned *ringMask = nullptr;
+        io_uring_cqe *cqes = nullptr;
+    };
+
+    bool Init();
+    bool MapRings(const io_uring_params &params);
+    void UnmapRings() noexcept;
+
+    io_uring_sqe *GetSqe();
+    unsigned PublishSqes();
+    int Enter(unsigned toSubmit, unsigned minComplete, int timeOutMs);
+    void QueuePollAdd(int fd, Registration &registration);
+    void QueuePollRemove(int fd, Registration &registration);
+    void ReapCompletions(std::vector<EventChannel *> &activeChannels);
+
+    static uint64_t MakeUserData(int fd, uint32_t generation);
+
+    static constexpr unsigned RING_ENTRIES = 256;
+    // multishot polls may post many completions, and the kernel ends them when the cq ring overflows.
+    static constexpr unsigned CQ_ENTRIES = RING_ENTRIES * 16;
+    OHOS::UniqueFd ringFd_;
+    void *sqRingPtr_ = nullptr;
+    std::size_t sqRingSize_ = 0;
+    void *cqRingPtr_ = nullptr;
+    std::size_t cqRingSize_ = 0;
+    io_uring_sqe *sqesPtr_ = nullptr;
+    std::size_t sqesSize_ = 0;
+    unsigned sqEntries_ = 0;
+    SubmissionQueue sq_;
+    CompletionQueue cq_;
+
+    uint32_t nextGeneration_ = 0;
+    uint64_t pollCount_ = 0;
+    std::unordered_map<int, Registration> channels_;
+};
+} // namespace FT
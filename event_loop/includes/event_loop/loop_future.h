@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "noncopyable_hal.h"
+#include "unique_function.h"
+
+namespace FT {
+class EventLoop;
+
+namespace detail {
+// run @func in @loop through EventLoop::QueueToLoop, or right here if @loop is null.
+void PostToLoop(EventLoop *loop, UniqueFunction<void()> &&func);
+// futex wait until *@word is not @expected any more.
+void FutexWait(std::atomic<uint32_t> &word, uint32_t expected);
+void FutexWakeAll(std::atomic<uint32_t> &word);
+// logs and aborts, the result of a broken future was asked for.
+[[noreturn]] void AbortBrokenFuture();
+
+struct VoidResult {};
+
+// State shared by a LoopFuture and the task which produces its result.
+// It is reference counted, and the subclasses carry the task in the same allocation.
+template <typename T>
+class LoopFutureState : NonCopyable {
+public:
+    using Result = std::conditional_t<std::is_void_v<T>, VoidResult, T>;
+
+    LoopFutureState() = default;
+    virtual ~LoopFutureState() noexcept = default;
+
+    void AddRef() noexcept
+    {
+        refCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release() noexcept
+    {
+        if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    bool IsReady() const noexcept
+    {
+        return (status_.load(std::memory_order_acquire) & READY) != 0;
+    }
+
+    // the producer went away without setting the result, only meaningful once ready.
+    bool IsBroken() const noexcept
+    {
+        return (status_.load(std::memory_order_acquire) & BROKEN) != 0;
+    }
+
+    void Wait()
+    {
+        uint32_t status = status_.load(std::memory_order_acquire);
+        while ((status & READY) == 0) {
+            if ((status & WAITER) == 0 &&
+                !status_.compare_exchange_weak(status, status | WAITER, std::memory_order_acquire)) {
+                continue;
+            }
+            FutexWait(status_, status | WAITER);
+            status = status_.load(std::memory_order_acquire);
+        }
+    }
+
+    Result TakeResult()
+    {
+        Wait();
+        if (!result_.has_value()) {
+            AbortBrokenFuture();
+        }
+        return std::move(*result_);
+    }
+
+    void SetResult(Result &&result)
+    {
+        result_.emplace(std::move(result));
+        MarkReady(READY);
+    }
+
+    // the producer is destroyed without a result, wakes the waiters and the continuation anyway.
+    void SetBroken()
+    {
+        MarkReady(READY | BROKEN);
+    }
+
+    // @cont runs with the result in @loop once the result is set, holding a reference to this state.
+    void SetContinuation(EventLoop *loop, UniqueFunction<void()> &&cont)
+    {
+        continuationLoop_ = loop;
+        continuation_ = std::move(cont);
+        uint32_t prev = status_.fetch_or(CONTINUATION, std::memory_order_acq_rel);
+        if (prev & READY) {
+            DispatchContinuation();
+        }
+    }
+
+private:
+    void MarkReady(uint32_t bits)
+    {
+        uint32_t prev = status_.fetch_or(bits, std::memory_order_acq_rel);
+        if (prev & WAITER) {
+            FutexWakeAll(status_);
+        }
+        if (prev & CONTINUATION) {
+            DispatchContinuation();
+        }
+    }
+
+    void DispatchContinuation()
+    {
+        PostToLoop(continuationLoop_, std::move(continuation_));
+    }
+
+    static constexpr uint32_t READY = 0x1;
+    static constexpr uint32_t WAITER = 0x2;       // a thread sleeps in Wait().
+    static constexpr uint32_t CONTINUATION = 0x4; // continuation_ is set.
+    static constexpr uint32_t BROKEN = 0x8;       // ready without a result.
+
+    std::atomic<uint32_t> refCount_{1};
+    std::atomic<uint32_t> status_{0};
+    std::optional<Result> result_;
+    EventLoop *continuationLoop_ = nullptr;
+    UniqueFunction<void()> continuation_;
+};
+
+// the state of EventLoop::Schedule, holding the task itself to make it a single allocation.
+template <typename T, typename Task>
+class ScheduledTaskState final : public LoopFutureState<T> {
+public:
+    explicit ScheduledTaskState(Task &&task) : task_(std::move(task)) {}
+    ~ScheduledTaskState() noexcept override = default;
+
+    void Run()
+    {
+        if constexpr (std::is_void_v<T>) {
+            task_();
+            this->SetResult(VoidResult());
+        } else {
+            this->SetResult(task_());
+        }
+    }
+
+private:
+    Task task_;
+};
+
+// movable reference to a LoopFutureState, keeps the lambdas capturing it as small as one pointer.
+template <typename State>
+class StateRef {
+public:
+    explicit StateRef(State *state) noexcept : state_(state) {}
+    StateRef(StateRef &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+    StateRef &operator=(StateRef &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+    StateRef(const StateRef &) = delete;
+    StateRef &operator=(const StateRef &) = delete;
+    ~StateRef() noexcept
+    {
+        Reset();
+    }
+
+    State *operator->() const noexcept
+    {
+        return state_;
+    }
+    State *Get() const noexcept
+    {
+        return state_;
+    }
+    State *Detach() noexcept
+    {
+        return std::exchange(state_, nullptr);
+    }
+
+private:
+    void Reset() noexcept
+    {
+        if (state_ != nullptr) {
+            std::exchange(state_, nullptr)->Release();
+        }
+    }
+
+    State *state_ = nullptr;
+};
+
+// the producer's reference to a LoopFutureState, held by the queued functor or the coroutine frame.
+// If it is dropped before the result is set (e.g. the loop is destroyed with the functor pending),
+// the state is marked broken so that Wait() returns instead of blocking forever.
+template <typename State>
+class PromiseRef {
+public:
+    explicit PromiseRef(State *state) noexcept : state_(state) {}
+    PromiseRef(PromiseRef &&other) noexcept = default;
+    PromiseRef &operator=(PromiseRef &&other) noexcept
+    {
+        if (this != &other) {
+            Break();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+    ~PromiseRef() noexcept
+    {
+        Break();
+    }
+
+    State *operator->() const noexcept
+    {
+        return state_.Get();
+    }
+
+private:
+    // only the producer sets the result, so checking it here doesn't race.
+    void Break() noexcept
+    {
+        if (state_.Get() != nullptr && !state_->IsReady()) {
+            state_->SetBroken();
+        }
+    }
+
+    StateRef<State> state_;
+};
+} // namespace detail
+
+// Result of EventLoop::Schedule. Unlike std::future it costs one allocation shared with the task,
+// waits on a futex instead of a mutex and condvar, and can hand the result to a continuation
+// on a chosen loop instead of blocking a thread.
+// Wait() and Get() must not be called in the loop thread which runs the task.
+// If the task is destroyed without running, the future becomes ready and broken: Wait() returns,
+// Get() aborts unless T is void, and the continuation of Then() is dropped.
+template <typename T>
+class LoopFuture {
+public:
+    LoopFuture() noexcept = default;
+    explicit LoopFuture(detail::LoopFutureState<T> *state) noexcept : state_(state) {}
+    LoopFuture(LoopFuture &&other) noexcept = default;
+    LoopFuture &operator=(LoopFuture &&other) noexcept = default;
+    ~LoopFuture() noexcept = default;
+
+    bool Valid() const noexcept
+    {
+        return state_.Get() != nullptr;
+    }
+
+    bool IsReady() const noexcept
+    {
+        return Valid() && state_->IsReady();
+    }
+
+    // ready without a result, the task was destroyed before it ran.
+    bool IsBroken() const noexcept
+    {
+        return IsReady() && state_->IsBroken();
+    }
+
+    void Wait() const
+    {
+        state_->Wait();
+    }
+
+    // waits for the result and moves it out, the future is invalid after that.
+    T Get()
+    {
+        detail::StateRef<detail::LoopFutureState<T>> state(std::move(state_));
+        if constexpr (std::is_void_v<T>) {
+            state->Wait();
+        } else {
+            return state->TakeResult();
+        }
+    }
+
+    // run @func(result) (or @func() for void) in @loop once the result is ready, without blocking.
+    // @loop: null to run it in the thread which sets the result. The future is invalid after that.
+    template <typename Func>
+    void Then(EventLoop *loop, Func func)
+    {
+        detail::LoopFutureState<T> *state = state_.Get();
+        state->SetContinuation(loop, [ref(std::move(state_)), func(std::move(func))]() mutable {
+            if (ref->IsBroken()) {
+                return;
+            }
+            if constexpr (std::is_void_v<T>) {
+                func();
+            } else {
+                func(ref->TakeResult());
+            }
+        });
+    }
+
+private:
+    detail::StateRef<detail::LoopFutureState<T>> state_{nullptr};
+};
+} // namespace FT
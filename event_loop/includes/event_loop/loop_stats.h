@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "noncopyable_hal.h"
+
+namespace FT {
+namespace detail {
+// cheap monotonic counter to time the loop: the TSC on x86, the virtual counter on aarch64,
+// CLOCK_MONOTONIC in nanoseconds elsewhere. Comparable between the threads of a process.
+inline uint64_t ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cycles = 0;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(cycles));
+    return cycles;
+#else
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+// nanoseconds per cycle of ReadCycles, calibrated by the first call.
+double NanosPerCycle();
+
+inline uint64_t CyclesToNanos(uint64_t cycles)
+{
+    static const double nanosPerCycle = NanosPerCycle();
+    return static_cast<uint64_t>(static_cast<double>(cycles) * nanosPerCycle);
+}
+} // namespace detail
+
+// copy of a LatencyHistogram, values in nanoseconds.
+struct HistogramSnapshot {
+    static constexpr std::size_t BUCKET_NUM = 312;
+
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::array<uint64_t, BUCKET_NUM> buckets{};
+
+    // upper bound of the bucket where the @quantile (0 ~ 1) of the values falls, 0 if empty.
+    uint64_t Percentile(double quantile) const;
+    uint64_t Average() const
+    {
+        return count == 0 ? 0 : sum / count;
+    }
+};
+
+// HDR style log-linear histogram: every power of two is split into 8 buckets, so a value is
+// off by at most 12.5%. Values up to 2^40 ns are kept, bigger ones fall into the last bucket.
+// Only one thread may record, any thread may take a snapshot: recording is plain relaxed loads
+// and stores, without any locked instruction.
+class LatencyHistogram : NonCopyable {
+public:
+    static constexpr std::size_t BUCKET_NUM = HistogramSnapshot::BUCKET_NUM;
+
+    LatencyHistogram() = default;
+    ~LatencyHistogram() noexcept = default;
+
+    void Record(uint64_t nanos)
+    {
+        Bump(buckets_[BucketIndex(nanos)], 1);
+        Bump(sum_, nanos);
+        if (nanos > max_.load(std::memory_order_relaxed)) {
+            max_.store(nanos, std::memory_order_relaxed);
+        }
+    }
+
+    // the recording thread only.
+    void Reset();
+
+    HistogramSnapshot Snapshot() const;
+
+    static std::size_t BucketIndex(uint64_t nanos);
+    // the largest value which falls into bucket @index.
+    static uint64_t BucketUpperBound(std::size_t index);
+
+private:
+    static void Bump(std::atomic<uint64_t> &counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_NUM> buckets_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Latencies of one EventLoop's iterations, recorded by the loop thread and readable by any thread.
+class LoopStats : NonCopyable {
+public:
+    // dispatch time of the channels are also counted by fd, the ones not less than this share a row.
+    static constexpr int MAX_TRACKED_FD = 128;
+
+    LoopStats() = default;
+    ~LoopStats() noexcept = default;
+
+    void RecordPoll(uint64_t cycles)
+    {
+        poll_.Record(detail::CyclesToNanos(cycles));
+    }
+    void RecordDispatch(int fd, uint64_t cycles);
+    void RecordTimers(uint64_t cycles)
+    {
+        timers_.Record(detail::CyclesToNanos(cycles));
+    }
+    void RecordFunctors(uint64_t cycles)
+    {
+        functors_.Record(detail::CyclesToNanos(cycles));
+    }
+    void RecordQueueDelay(uint64_t cycles)
+    {
+        queueDelay_.Record(detail::CyclesToNanos(cycles));
+    }
+
+    // the loop thread only.
+    void Reset();
+
+    // append a readable table of the latencies to @out.
+    void Dump(std::string &out) const;
+
+private:
+    struct ChannelDispatch {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    LatencyHistogram poll_;       // time blocked in EventPoller::PollOnce.
+    LatencyHistogram dispatch_;   // time of each EventChannel::HandleEvent.
+    LatencyHistogram timers_;     // time of the timer callbacks expired together.
+    LatencyHistogram functors_;   // time of each ExecPendingFunctors.
+    LatencyHistogram queueDelay_; // time from QueueToLoop to the functor's execution.
+    std::array<ChannelDispatch, MAX_TRACKED_FD + 1> channels_{};
+};
+} // namespace FT
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "loop_stats.h"
+#include "noncopyable_hal.h"
+#include "types.h"
+
+namespace FT {
+// what the loop thread is busy with.
+enum class LoopPhase : uint32_t {
+    IDLE = 0,     // blocked in the poller.
+    DISPATCH = 1, // handling the events of a channel, including the timer callbacks.
+    FUNCTORS = 2, // executing the pending functors.
+};
+
+const char *LoopPhaseToString(LoopPhase phase);
+
+// Written by the loop thread on every iteration, read by its LoopWatchdog.
+class LoopHeartbeat : NonCopyable {
+public:
+    LoopHeartbeat() = default;
+    ~LoopHeartbeat() noexcept = default;
+
+    void BeginIteration()
+    {
+        // release: a watchdog seeing the new iteration number also sees the 0 stored by EndIteration,
+        // and one seeing this start also sees the new number. See LoopWatchdog::Check.
+        iteration_.store(iteration_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        busySince_.store(detail::ReadCycles(), std::memory_order_release);
+    }
+    void SetActivity(LoopPhase phase, int fd = INVALID_FD)
+    {
+        phase_.store(phase, std::memory_order_relaxed);
+        fd_.store(fd, std::memory_order_relaxed);
+    }
+    void EndIteration()
+    {
+        phase_.store(LoopPhase::IDLE, std::memory_order_relaxed);
+        busySince_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t Iteration() const
+    {
+        return iteration_.load(std::memory_order_acquire);
+    }
+    // cycles of detail::ReadCycles when the current iteration began, 0 if idle.
+    uint64_t BusySince() const
+    {
+        return busySince_.load(std::memory_order_acquire);
+    }
+    LoopPhase Phase() const
+    {
+        return phase_.load(std::memory_order_relaxed);
+    }
+    int Fd() const
+    {
+        return fd_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> iteration_{0};
+    std::atomic<uint64_t> busySince_{0};
+    std::atomic<LoopPhase> phase_{LoopPhase::IDLE};
+    std::atomic<int> fd_{INVALID_FD};
+};
+
+// the stalls seen by a LoopWatchdog.
+struct StallStats {
+    uint64_t stalls = 0;          // iterations which exceeded the budget.
+    TimeType longestMicros = 0;   // the longest stall observed, in micro seconds.
+    TimeType lastMicros = 0;      // how long the last stall was when it was reported.
+    LoopPhase lastPhase = LoopPhase::IDLE;
+    int lastFd = INVALID_FD;      // the channel being dispatched in the last stall, if any.
+    std::string lastStack;        // the symbolized stack sample of the last stall.
+};
+
+// Thread watching the heartbeat of an EventLoop. When an iteration takes longer than the budget,
+// it logs what the loop is doing together with a stack sample of the loop thread, taken by a
+// signal handler in that thread, and counts the stall. The signal is installed with SA_RESTART,
+// but the syscalls which are never restarted (nanosleep, epoll_wait...) may still see EINTR.
+class LoopWatchdog : NonCopyable {
+public:
+    // @loopTid: the loop thread to sample.
+    // @budget: longest iteration allowed, in micro seconds.
+    LoopWatchdog(const LoopHeartbeat &heartbeat, ThreadId loopTid, TimeType budget);
+    ~LoopWatchdog() noexcept;
+
+    // can be called from any thread.
+    StallStats GetStats() const;
+
+    // append the stall stats to @out.
+    void Dump(std::string &out) const;
+
+private:
+    void WatchThreadFunc();
+    void Check();
+    std::string CaptureLoopStack();
+
+    const LoopHeartbeat &heartbeat_;
+    ThreadId loopTid_ = -1;
+    TimeType budget_ = 0;
+
+    uint64_t reportedIteration_ = 0; // only one report per stalled iteration.
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    bool stopped_ = false;
+    StallStats stats_;
+    std::thread thread_;
+};
+} // namespace FT
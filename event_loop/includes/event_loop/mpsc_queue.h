@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "noncopyable_hal.h"
+
+namespace FT {
+// Intrusive node of MpscQueue, the element type must derive from it.
+struct MpscQueueNode {
+    std::atomic<MpscQueueNode *> next{nullptr};
+};
+
+// Lock-free multi-producer/single-consumer intrusive queue (Dmitry Vyukov's algorithm).
+// Push() is wait-free and can be called from any thread,
+// Pop() and DrainBatch() must only be called from the single consumer thread.
+// The queue never owns the nodes, the consumer is responsible for releasing the popped ones.
+template <typename T>
+class MpscQueue : NonCopyable {
+public:
+    MpscQueue() noexcept : back_(&stub_), front_(&stub_) {}
+    ~MpscQueue() noexcept = default;
+
+    // @return: true if the queue was empty before this push.
+    bool Push(T *node) noexcept
+    {
+        return PushNode(static_cast<MpscQueueNode *>(node)) == &stub_;
+    }
+
+    // @return: nullptr if the queue is empty, or a producer is in the middle of a push,
+    // in the latter case the producer will complete it soon and the node can be popped later.
+    T *Pop() noexcept
+    {
+        MpscQueueNode *front = front_;
+        MpscQueueNode *next = front->next.load(std::memory_order_acquire);
+        if (front == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            front_ = next;
+            front = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            front_ = next;
+            return static_cast<T *>(front);
+        }
+
+        if (front != back_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        PushNode(&stub_);
+        next = front->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            front_ = next;
+            return static_cast<T *>(front);
+        }
+        return nullptr;
+    }
+
+    // Pop and handle the nodes which were pushed before this call, the nodes pushed
+    // during the drain (including the ones pushed by @handler) are left for the next drain.
+    // @handler: void(T *), takes over the ownership of the popped node.
+    // @return: number of nodes handled.
+    template <typename Handler>
+    std::size_t DrainBatch(Handler &&handler)
+    {
+        return DrainBatchUntil(BatchEnd(), std::forward<Handler>(handler), []() { return false; });
+    }
+
+    // the end of the nodes pushed so far, for a later DrainBatchUntil. null if there is nothing to drain.
+    // It is the stub when Pop() pushed it back behind the last node, the batch then ends at the stub.
+    MpscQueueNode *BatchEnd() const noexcept
+    {
+        MpscQueueNode *last = back_.load(std::memory_order_acquire);
+        return (last == &stub_ && front_ == &stub_) ? nullptr : last;
+    }
+
+    // DrainBatch up to @batchEnd got by BatchEnd() earlier, which stops early once @shouldStop()
+    // returns true, the rest is left in the queue.
+    // @shouldStop: bool(), checked after each handled node.
+    template <typename Handler, typename ShouldStop>
+    std::size_t DrainBatchUntil(MpscQueueNode *batchEnd, Handler &&handler, ShouldStop &&shouldStop)
+    {
+        if (batchEnd == nullptr) {
+            return 0;
+        }
+
+        std::size_t count = 0;
+        // Pop() never returns the stub, it skips it when it reaches the front.
+        while (batchEnd != &stub_ || front_ != &stub_) {
+            T *node = Pop();
+            if (node == nullptr) {
+                break;
+            }
+            ++count;
+            bool isLast = (static_cast<MpscQueueNode *>(node) == batchEnd);
+            handler(node);
+            if (isLast || shouldStop()) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    // only reliable in the consumer thread.
+    bool Empty() const noexcept
+    {
+        return front_ == &stub_ && stub_.next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    MpscQueueNode *PushNode(MpscQueueNode *node) noexcept
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscQueueNode *prev = back_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+        return prev;
+    }
+
+    // keep the producers' end and the consumer's end in different cache lines.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    alignas(CACHE_LINE_SIZE) std::atomic<MpscQueueNode *> back_;
+    alignas(CACHE_LINE_SIZE) MpscQueueNode *front_;
+    MpscQueueNode stub_;
+};
+} // namespace FT
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "timer_storage.h"
+
+namespace FT {
+using TimerEntry = std::pair<TimeStamp, TimerId>; // Make sure every TimerEntry is unique.
+using TimerEntrySet = std::set<TimerEntry>;       // To sort timers ordered by expireTime
+
+class OrderedTimerSet final : public TimerStorage {
+public:
+    OrderedTimerSet() = default;
+    ~OrderedTimerSet() noexcept override = default;
+
+    void Insert(Timer *timer) override;
+    void Remove(Timer *timer) override;
+    void TakeExpired(TimeStamp now, std::vector<Timer *> &expired) override;
+    TimeStamp NextExpireTime() const override;
+    TimeStamp NextDeadline() const override;
+    std::size_t Size() const override
+    {
+        return timerEntries_.size();
+    }
+
+private:
+    void RecycleNode(TimerEntrySet::node_type &&node);
+
+    TimerEntrySet timerEntries_;
+    // nodes extracted from timerEntries_, reused by Insert so that a steady timer load does not allocate.
+    static constexpr std::size_t MAX_FREE_NODES = 256;
+    std::vector<TimerEntrySet::node_type> freeNodes_;
+};
+} // namespace FT
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace FT {
+enum class SchedPolicy {
+    INHERIT, // keep the policy of the creating thread.
+    OTHER,   // SCHED_OTHER with ThreadOptions::nice.
+    FIFO,    // SCHED_FIFO with ThreadOptions::priority, needs CAP_SYS_NICE.
+    RR,      // SCHED_RR with ThreadOptions::priority, needs CAP_SYS_NICE.
+};
+
+enum class MemoryPolicy {
+    INHERIT,    // keep the memory policy of the creating thread.
+    LOCAL,      // allocate on the node of the cpu running the thread.
+    BIND,       // allocate only on ThreadOptions::memoryNodes.
+    INTERLEAVE, // interleave the pages over ThreadOptions::memoryNodes.
+};
+
+// How a loop thread runs, applied by the thread itself before its EventLoop is constructed,
+// so the loop's memory is first touched under the final affinity and memory policy.
+struct ThreadOptions {
+    std::vector<int> cpus;   // cpus the thread may run on, empty for no affinity.
+    // EventLoopThreadPool only: pin its thread i to cpus[i % cpus.size()] instead of the whole set.
+    bool spreadCpus = false;
+    SchedPolicy policy = SchedPolicy::INHERIT;
+    int priority = 0;        // 1 ~ 99, for SchedPolicy::FIFO and SchedPolicy::RR.
+    int nice = 0;            // -20 ~ 19, for SchedPolicy::OTHER.
+    MemoryPolicy memoryPolicy = MemoryPolicy::INHERIT;
+    std::vector<int> memoryNodes; // NUMA nodes of MemoryPolicy::BIND and MemoryPolicy::INTERLEAVE.
+};
+
+// name the calling thread @name (truncated to the 15 characters the kernel keeps) and apply @options to it.
+// A failed option, like a real-time policy without the privilege, is logged and skipped.
+// @return: whether all the options are applied.
+bool ApplyThreadOptions(const std::string &name, const ThreadOptions &options);
+} // namespace FT
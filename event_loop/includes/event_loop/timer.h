@@ -15,10 +15,11 @@
 
 #pragma once
 
-#include <functional>
+#include <atomic>
 
 #include "noncopyable_hal.h"
 #include "timestamp.h"
+#include "unique_function.h"
 
 namespace FT {
 class Timer;
@@ -48,23 +49,49 @@ struct TimerId {
     }
     bool operator<(const TimerId &other) const
     {
-        return id < other.id || timer < other.timer;
+        if (id != other.id) {
+            return id < other.id;
+        }
+        return timer < other.timer;
     }
 };
 
-using TimerCallback = std::function<void()>;
+using TimerCallback = UniqueFunction<void()>;
 
-class Timer : NonCopyable {
+namespace detail {
+// intrusive list hook of Timer, used by the timer storages and the TimerPool's free list.
+struct TimerListNode {
+    TimerListNode *prev = nullptr;
+    TimerListNode *next = nullptr;
+};
+} // namespace detail
+
+enum class TimerState : uint8_t {
+    FREE,      // in the TimerPool, the TimerId of it is stale.
+    PENDING,   // acquired by a caller, its insertion is queued to the loop thread.
+    SCHEDULED, // waiting in a timer storage.
+    EXPIRED,   // taken out of the storage and being executed.
+};
+
+class Timer : public detail::TimerListNode, NonCopyable {
 public:
+    Timer() = default;
     // @callback: TimerCallback
     // @expireTime: expire TimeStamp
     // @interval: interval in micro seconds, 0 for only run once.
-    Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0);
+    // @slack: how late the timer may fire in micro seconds, so that it shares a wakeup with others.
+    Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
     ~Timer() noexcept = default;
 
+    // reuse this timer with a new TimerId, params are the same as the constructor's.
+    void Reset(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
+    // drop the callback and invalidate the TimerId.
+    void Release();
+
+    // can be called from any thread.
     TimerId Id() const
     {
-        return id_;
+        return TimerId(seq_.load(std::memory_order_acquire), const_cast<Timer *>(this));
     }
     bool IsRepeat() const
     {
@@ -75,17 +102,61 @@ public:
     {
         return expireTime_;
     }
+    TimeType Slack() const
+    {
+        return slack_;
+    }
+    // the latest time the timer should fire.
+    TimeStamp Deadline() const
+    {
+        return TimeAdd(expireTime_, slack_);
+    }
+
+    TimerState State() const
+    {
+        return state_;
+    }
+    void SetState(TimerState state)
+    {
+        state_ = state;
+    }
+
+    // a timer canceled while it is expired will not be restarted.
+    bool IsCanceled() const
+    {
+        return canceled_;
+    }
+    void SetCanceled()
+    {
+        canceled_ = true;
+    }
 
     // only valid when the timer is repeated.
     void Restart(TimeStamp now);
     void Execute();
 
 private:
+    friend class TimerWheel;
+    friend class TimerPool;
+
     TimerCallback cb_;
     TimeStamp expireTime_;
     TimeType interval_ = 0;
+    TimeType slack_ = 0;
     bool repeat_ = false;
-    TimerId id_;
+    bool canceled_ = false;
+    TimerState state_ = TimerState::FREE;
+    // the loop thread may check a stale TimerId while another thread is reusing this timer.
+    std::atomic<uint64_t> seq_{0};
+
+    // position in TimerPool.
+    uint32_t poolIndex_ = 0;
+    std::atomic<uint32_t> poolNext_{0};
+
+    // position in TimerWheel.
+    uint8_t wheelLevel_ = 0;
+    uint16_t wheelSlot_ = 0;
+    uint64_t wheelTick_ = 0;
 };
 } // namespace FT
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+#include "timer.h"
+
+namespace FT {
+// Owns the memory of all timers of a TimerQueue. Timers are allocated in chunks and recycled
+// through a free list, they are never freed before the pool, so a stale TimerId can always be
+// checked safely by comparing it with Timer::Id().
+// Acquire() is lock-free and can be called from any thread (it only takes a lock to grow the pool),
+// Recycle() should only be called in the loop thread.
+class TimerPool : NonCopyable {
+public:
+    TimerPool() = default;
+    ~TimerPool() noexcept = default;
+
+    // params are the same as Timer's constructor.
+    // @return: a timer in TimerState::PENDING, nullptr if the pool is exhausted.
+    Timer *Acquire(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
+    void Recycle(Timer *timer);
+
+    std::size_t Capacity() const
+    {
+        return chunkCount_.load(std::memory_order_acquire) * CHUNK_SIZE;
+    }
+
+private:
+    // @return: false if the pool can not grow anymore.
+    bool Grow(uint64_t observedHead);
+    Timer *TimerAt(uint32_t index) const
+    {
+        return &chunks_[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+    // link [first, last] (already linked by poolNext_) to the head of the free list.
+    void PushFreeList(Timer *first, Timer *last);
+
+    static constexpr std::size_t CHUNK_SIZE = 256;
+    static constexpr std::size_t MAX_CHUNK_COUNT = 4096;
+    static constexpr uint32_t INDEX_BITS = 32;
+    static constexpr uint64_t INDEX_MASK = (uint64_t(1) << INDEX_BITS) - 1;
+
+    std::mutex growMutex_;
+    std::atomic<std::size_t> chunkCount_{0};
+    std::array<std::unique_ptr<Timer[]>, MAX_CHUNK_COUNT> chunks_;
+    // low 32 bits: index + 1 of the first free timer (0 for empty), high 32 bits: ABA tag.
+    std::atomic<uint64_t> freeHead_{0};
+};
+} // namespace FT
@@ -15,53 +15,76 @@
 
 #pragma once
 
-#include <set>
-#include <unordered_map>
 #include <vector>
 
 #include "unique_fd.h"
 #include "event_channel.h"
-#include "timer.h"
+#include "loop_stats.h"
+#include "timer_pool.h"
+#include "timer_storage.h"
 
 namespace FT {
 class EventLoop;
 
-using TimerPtr = std::unique_ptr<Timer>;
-using TimerMap = std::unordered_map<TimerId, TimerPtr>; // To hold timers, manager the timers' ownership.
-using TimerEntry = std::pair<TimeStamp, TimerId>;       // Make sure every TimerEntry is unique.
-using TimerEntrySet = std::set<TimerEntry>;             // To sort timers ordered by expireTime
+// counters of the timerFd work done by a TimerQueue.
+struct TimerStats {
+    uint64_t wakeups = 0;       // expirations of the timerFd handled.
+    uint64_t rearms = 0;        // timerfd_settime calls.
+    uint64_t rearmsSkipped = 0; // new timers which found the timerFd armed inside their slack.
+    uint64_t wakeupsSaved = 0;  // timers fired by the wakeup of an earlier timer thanks to its slack.
+};
 
 class TimerQueue : NonCopyable {
 public:
-    explicit TimerQueue(EventLoop *loop);
+    // @backend: how the scheduled timers are kept, see TimerQueueBackend.
+    // @stats: where the time of the timer callbacks is recorded, null to not record it.
+    explicit TimerQueue(EventLoop *loop, TimerQueueBackend backend = TimerQueueBackend::ORDERED_SET,
+        LoopStats *stats = nullptr);
     ~TimerQueue() noexcept;
 
     // @callback: TimerCallback
     // @expireTime: expire TimeStamp
     // @interval: interval in micro seconds, 0 for only run once.
-    // @return: TimerId
-    TimerId AddTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0);
+    // @slack: how late the timer may fire in micro seconds. The timers whose windows
+    // [expireTime, expireTime + slack] overlap are fired by one wakeup of the timerFd.
+    // @return: TimerId, null if there is no memory for a new timer.
+    // can be called from any thread without blocking, the timer is inserted in the loop thread later.
+    TimerId AddTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval = 0, TimeType slack = 0);
 
     // @timerId: TimerId to cancel
     // can only be called in loop thread
     void CancelTimer(const TimerId &timerId);
 
+    // can be called from any thread.
+    TimerStats GetStats() const;
+
 private:
     void AssertInLoopThread();
 
-    void AddTimerInLoop(std::unique_ptr<Timer> &&timer);
+    void AddTimerInLoop(Timer *timer);
     void CancelTimerInLoop(const TimerId &timerId);
-    std::vector<TimerEntry> GetExpiredTimers(TimeStamp receivedTime);
 
     void HandleRead(TimeStamp receivedTime);
     void TimerFdRead();
+    // rearm the timerFd if it is not armed early enough for the next timer.
+    void TimerFdUpdate();
     void TimerFdReset(TimeStamp expireTime);
 
     EventLoop *loop_ = nullptr;
     OHOS::UniqueFd timerFd_;
     std::unique_ptr<EventChannel> timerFdChannel_;
 
-    TimerMap timers_;
-    TimerEntrySet timerEntries_;
+    TimerPool timerPool_;
+    std::unique_ptr<TimerStorage> timers_;
+    std::vector<Timer *> expiredTimers_; // reused by HandleRead.
+    TimeStamp armedTime_;                // TimeStamp::Invalid() if the timerFd is not armed.
+    bool armedLate_ = false;             // armed after the next expire time, by the slack of the timers.
+    LoopStats *stats_ = nullptr;
+
+    // written by the loop thread only.
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> rearms_{0};
+    std::atomic<uint64_t> rearmsSkipped_{0};
+    std::atomic<uint64_t> wakeupsSaved_{0};
 };
 } // namespace FT
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "timer.h"
+
+namespace FT {
+enum class TimerQueueBackend {
+    ORDERED_SET,  // std::set sorted by expire time, exact but O(log n) insert and cancel.
+    TIMING_WHEEL, // hierarchical timing wheel, O(1) insert and cancel, fires with tick granularity.
+};
+
+// Keeps the scheduled timers of a TimerQueue ordered by their expire time.
+// The storage does not own the timers, they are owned by TimerQueue's TimerPool.
+// not thread safe, should only be used in the loop thread.
+class TimerStorage : NonCopyable {
+public:
+    virtual ~TimerStorage() noexcept = default;
+
+    // @timer: a timer which is not in the storage, put it by its ExpireTime().
+    virtual void Insert(Timer *timer) = 0;
+    // @timer: a timer which is in the storage.
+    virtual void Remove(Timer *timer) = 0;
+    // move the timers which are expired at @now out of the storage to @expired.
+    virtual void TakeExpired(TimeStamp now, std::vector<Timer *> &expired) = 0;
+    // @return: the time to check the storage again, TimeStamp::Invalid() if the storage is empty.
+    virtual TimeStamp NextExpireTime() const = 0;
+    // @return: the latest time to check the storage again without firing any timer after its
+    // Deadline(), TimeStamp::Invalid() if the storage is empty. The storages which can't tell it
+    // ignore the slack and return NextExpireTime().
+    virtual TimeStamp NextDeadline() const
+    {
+        return NextExpireTime();
+    }
+    virtual std::size_t Size() const = 0;
+
+    static std::unique_ptr<TimerStorage> Create(TimerQueueBackend backend);
+};
+} // namespace FT
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "timer_storage.h"
+
+namespace FT {
+// Hierarchical timing wheel (like the classic Linux kernel timer wheel).
+// Level 0 has 256 slots of one tick each, every upper level has 64 slots and each slot covers
+// a whole round of the level below it. The timers in an upper level are cascaded down
+// when the level below wraps around, so insert and cancel are O(1).
+// Timers are expired with tick granularity: a timer never fires before its expire time,
+// but may fire up to one tick later.
+class TimerWheel final : public TimerStorage {
+public:
+    static constexpr TimeType DEFAULT_TICK_MICROS = MICRO_SECS_PER_MILLISECOND;
+
+    // @startTime: time of tick 0.
+    // @tickMicros: length of a tick in micro seconds.
+    explicit TimerWheel(TimeStamp startTime = TimeStamp::Now(), TimeType tickMicros = DEFAULT_TICK_MICROS);
+    ~TimerWheel() noexcept override = default;
+
+    void Insert(Timer *timer) override;
+    void Remove(Timer *timer) override;
+    void TakeExpired(TimeStamp now, std::vector<Timer *> &expired) override;
+    TimeStamp NextExpireTime() const override;
+    std::size_t Size() const override
+    {
+        return size_;
+    }
+
+private:
+    static constexpr int LEVEL_COUNT = 5;
+    static constexpr int LEVEL0_BITS = 8;
+    static constexpr int LEVELN_BITS = 6;
+    static constexpr int MAX_SLOT_COUNT = 1 << LEVEL0_BITS;
+    static constexpr int BITMAP_WORD_BITS = 64;
+    static constexpr uint64_t MAX_TICKS = (uint64_t(1) << (LEVEL0_BITS + LEVELN_BITS * (LEVEL_COUNT - 1))) - 1;
+
+    struct Level {
+        int shift = 0;       // tick bits below this level.
+        uint32_t mask = 0;   // slot count - 1.
+        std::array<detail::TimerListNode, MAX_SLOT_COUNT> slots; // sentinels of circular lists.
+        std::array<uint64_t, MAX_SLOT_COUNT / BITMAP_WORD_BITS> occupied{};
+    };
+
+    uint64_t TickCeil(TimeStamp time) const;
+    uint64_t TickFloor(TimeStamp time) const;
+    TimeStamp TickTime(uint64_t tick) const;
+
+    void Place(Timer *timer);
+    void Unlink(Timer *timer);
+    void Cascade();
+    // @return: distance from @from to the first non-empty slot (cyclic), -1 if the level is empty.
+    int FindOccupied(const Level &level, uint32_t from) const;
+
+    TimeStamp startTime_;
+    TimeType tickMicros_ = DEFAULT_TICK_MICROS;
+    uint64_t currentTick_ = 0; // the next tick to expire.
+    std::size_t size_ = 0;
+    std::array<Level, LEVEL_COUNT> levels_;
+};
+} // namespace FT
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace FT {
+template <typename Signature>
+class UniqueFunction;
+
+// Move-only replacement of std::function for the loop's tasks and callbacks.
+// Callables up to INLINE_SIZE bytes (which covers the usual lambdas capturing a few pointers or a
+// shared_ptr) are stored in place, so constructing, moving and calling them never allocates.
+// Being move-only, it also accepts callables capturing move-only objects.
+template <typename R, typename... Args>
+class UniqueFunction<R(Args...)> {
+public:
+    static constexpr std::size_t INLINE_SIZE = 6 * sizeof(void *);
+
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {}
+
+    template <typename F, typename Callable = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Callable, UniqueFunction> &&
+            std::is_invocable_r_v<R, Callable &, Args...>>>
+    UniqueFunction(F &&f)
+    {
+        if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable>) {
+            if (f == nullptr) {
+                return;
+            }
+        }
+
+        if constexpr (IsInline<Callable>()) {
+            ::new (static_cast<void *>(&storage_)) Callable(std::forward<F>(f));
+            ops_ = &INLINE_OPS<Callable>;
+        } else {
+            *reinterpret_cast<Callable **>(&storage_) = new Callable(std::forward<F>(f));
+            ops_ = &HEAP_OPS<Callable>;
+        }
+    }
+
+    UniqueFunction(UniqueFunction &&other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    UniqueFunction &operator=(UniqueFunction &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    UniqueFunction &operator=(std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, UniqueFunction>>>
+    UniqueFunction &operator=(F &&f)
+    {
+        return *this = UniqueFunction(std::forward<F>(f));
+    }
+
+    UniqueFunction(const UniqueFunction &) = delete;
+    UniqueFunction &operator=(const UniqueFunction &) = delete;
+
+    ~UniqueFunction() noexcept
+    {
+        Reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    // const like std::function's, the callable itself may still change its state.
+    R operator()(Args... args) const
+    {
+        return ops_->invoke(const_cast<Storage *>(&storage_), std::forward<Args>(args)...);
+    }
+
+    friend bool operator==(const UniqueFunction &f, std::nullptr_t) noexcept
+    {
+        return !f;
+    }
+    friend bool operator!=(const UniqueFunction &f, std::nullptr_t) noexcept
+    {
+        return static_cast<bool>(f);
+    }
+
+private:
+    using Storage = std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)>;
+
+    struct Ops {
+        R (*invoke)(Storage *storage, Args &&...args);
+        // move-construct dst from src and destroy src.
+        void (*relocate)(Storage *dst, Storage *src) noexcept;
+        void (*destroy)(Storage *storage) noexcept;
+    };
+
+    template <typename Callable>
+    static constexpr bool IsInline()
+    {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(Storage) &&
+            std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+    template <typename Callable>
+    static Callable *InlinePtr(Storage *storage)
+    {
+        return std::launder(reinterpret_cast<Callable *>(storage));
+    }
+
+    template <typename Callable>
+    static Callable *&HeapPtr(Storage *storage)
+    {
+        return *reinterpret_cast<Callable **>(storage);
+    }
+
+    template <typename Callable>
+    static constexpr Ops INLINE_OPS = {
+        [](Storage *storage, Args &&...args) -> R {
+            return static_cast<R>((*InlinePtr<Callable>(storage))(std::forward<Args>(args)...));
+        },
+        [](Storage *dst, Storage *src) noexcept {
+            ::new (static_cast<void *>(dst)) Callable(std::move(*InlinePtr<Callable>(src)));
+            InlinePtr<Callable>(src)->~Callable();
+        },
+        [](Storage *storage) noexcept { InlinePtr<Callable>(storage)->~Callable(); },
+    };
+
+    template <typename Callable>
+    static constexpr Ops HEAP_OPS = {
+        [](Storage *storage, Args &&...args) -> R {
+            return static_cast<R>((*HeapPtr<Callable>(storage))(std::forward<Args>(args)...));
+        },
+        [](Storage *dst, Storage *src) noexcept { HeapPtr<Callable>(dst) = HeapPtr<Callable>(src); },
+        [](Storage *storage) noexcept { delete HeapPtr<Callable>(storage); },
+    };
+
+    void MoveFrom(UniqueFunction &other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->relocate(&storage_, &other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void Reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    Storage storage_;
+    const Ops *ops_ = nullptr;
+};
+} // namespace FT
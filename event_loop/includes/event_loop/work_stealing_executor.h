@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "noncopyable_hal.h"
+#include "unique_function.h"
+
+namespace FT {
+// Thread pool for CPU heavy work which should not block an EventLoop.
+// Every worker owns a deque: tasks submitted by a worker are pushed to and popped from the back of its own deque,
+// an idle worker steals from the front of the others', tasks submitted by other threads go to a global
+// injection queue. Submit() can be called from any thread.
+class WorkStealingExecutor : NonCopyable {
+public:
+    using Task = UniqueFunction<void()>;
+
+    // @workerNum: number of worker threads, 0 means one less than the number of cores (at least 1).
+    explicit WorkStealingExecutor(std::size_t workerNum = 0, std::string name = "FTOffload");
+    // runs the tasks left in the queues, then joins the workers.
+    ~WorkStealingExecutor() noexcept;
+
+    void Submit(Task task);
+
+    std::size_t WorkerNum() const
+    {
+        return workers_.size();
+    }
+
+    const std::string &Name() const
+    {
+        return name_;
+    }
+
+    // executor shared by the EventLoops which are not given one, created on the first call.
+    static const std::shared_ptr<WorkStealingExecutor> &GetDefault();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerThreadFunc(std::size_t index);
+    bool TakeTask(std::size_t index, Task &task);
+    bool PopLocal(std::size_t index, Task &task);
+    bool PopGlobal(Task &task);
+    bool Steal(std::size_t thief, Task &task);
+    void NotifyOne();
+
+    std::string name_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex globalMutex_; // guards globalTasks_ and is the mutex of idleCond_.
+    std::deque<Task> globalTasks_;
+    std::condition_variable idleCond_;
+    std::atomic<std::size_t> pendingTasks_{0};
+    std::atomic<std::size_t> idleWorkers_{0};
+    std::atomic<bool> running_{true};
+};
+} // namespace FT
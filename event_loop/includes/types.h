@@ -37,6 +37,11 @@
 #define OE_UNLIKELY(x) (__builtin_expect(!!(x), 0))
 #endif
 
+// the compiler supports C++20 coroutines, which enables event_loop/coroutine.h.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define FT_HAS_COROUTINE 1
+#endif
+
 namespace FT {
 template <typename EnumType>
 inline constexpr typename std::underlying_type<EnumType>::type ECast(EnumType e)
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "epoll_poller.h"
+
+#include "types.h"
+#include "event_loop.h"
+
+#include "log.h"
+
+namespace FT {
+namespace detail {
+std::string EpollOperationToString(int operation)
+{
+    switch (operation) {
+        case EPOLL_CTL_ADD:
+            return "EpollCtlAdd";
+        case EPOLL_CTL_MOD:
+            return "EpollCtlMod";
+        case EPOLL_CTL_DEL:
+            return "EpollCtlDel";
+        default:
+            return "UnknownEpollCtl";
+    }
+}
+} // namespace detail
+
+EpollPoller::EpollPoller(EventLoop *eventLoop)
+    : EventPoller(eventLoop), epollFd_(::epoll_create1(EPOLL_CLOEXEC)), activeEvents_(eventSize_)
+{}
+
+EpollPoller::~EpollPoller() noexcept {}
+
+uint64_t EpollPoller::MakeTag(uint32_t slot, uint32_t generation)
+{
+    return (static_cast<uint64_t>(generation) << 32) | slot;
+}
+
+uint32_t EpollPoller::AllocSlot(EventChannel *channel)
+{
+    uint32_t slot = 0;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    slots_[slot].channel = channel;
+    return slot;
+}
+
+void EpollPoller::ReleaseSlot(uint32_t slot)
+{
+    slots_[slot].channel = nullptr;
+    ++slots_[slot].generation;
+    freeSlots_.emplace_back(slot);
+}
+
+TimeStamp EpollPoller::PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs)
+{
+    auto cnt = TEMP_FAILURE_RETRY(::epoll_wait(epollFd_.Get(), activeEvents_.data(), eventSize_, timeOutMs));
+    auto pollTime = TimeStamp::Now();
+    if (cnt < 0) {
+        LOG_WARN("epoll_wait error: %{public}s.", ErrnoToString(errno).c_str());
+    } else {
+        for (int i = 0; i < cnt; ++i) {
+            const auto &event = activeEvents_[i];
+            uint32_t slot = static_cast<uint32_t>(event.data.u64 & 0xFFFFFFFFu);
+            uint32_t generation = static_cast<uint32_t>(event.data.u64 >> 32);
+            if (OE_UNLIKELY(slot >= slots_.size() || slots_[slot].generation != generation ||
+                slots_[slot].channel == nullptr)) {
+                LOG_WARN("epoll_wait returned a stale channel(slot: %{public}u) in poller(%{public}i).",
+                    slot, epollFd_.Get());
+                continue;
+            }
+
+            EventChannel *channel = slots_[slot].channel;
+            SetReceivedEvents(channel, event.events);
+            activeChannels.emplace_back(channel);
+        }
+
+        if (static_cast<std::size_t>(cnt) == eventSize_) {
+            eventSize_ *= 2;
+            activeEvents_.resize(eventSize_);
+        }
+    }
+
+    return pollTime;
+}
+
+void EpollPoller::EpollCtl(int fd, uint32_t events, uint64_t tag, int operation)
+{
+    epoll_event epollEvent;
+    epollEvent.events = events;
+    epollEvent.data.u64 = tag;
+    int ret = TEMP_FAILURE_RETRY(::epoll_ctl(epollFd_.Get(), operation, fd, &epollEvent));
+    if (ret < 0) {
+        LOG_ERROR("%{public}s failed for EpollPoller(fd: %{public}i): %{public}s.",
+            detail::EpollOperationToString(operation).c_str(), fd, ErrnoToString(errno).c_str());
+    }
+}
+
+void EpollPoller::UpdateChannel(EventChannel *channel)
+{
+    if (channel == nullptr) {
+        return;
+    }
+
+    eventLoop_->AssertInLoopThread();
+
+    int fd = channel->Fd();
+    if (channel->HasNoEvent()) {
+        eventLoop_->RemoveChannel(fd);
+        return;
+    }
+
+    auto it = fdSlots_.find(fd);
+    if (it == fdSlots_.end()) {
+        // new channel
+        uint32_t slot = AllocSlot(channel);
+        EpollCtl(fd, ListeningEvents(channel), MakeTag(slot, slots_[slot].generation), EPOLL_CTL_ADD);
+        fdSlots_.emplace(fd, slot);
+    } else {
+        // modify channel
+        uint32_t slot = it->second;
+        slots_[slot].channel = channel;
+        EpollCtl(fd, ListeningEvents(channel), MakeTag(slot, slots_[slot].generation), EPOLL_CTL_MOD);
+    }
+}
+
+void EpollPoller::RemoveChannel(int fd)
+{
+    eventLoop_->AssertInLoopThread();
+
+    auto it = fdSlots_.find(fd);
+    if (it == fdSlots_.end()) {
+        LOG_WARN("Can't find channel %{public}i in poller %{public}i.", fd, epollFd_.Get());
+        return;
+    }
+
+    EpollCtl(fd, 0, 0, EPOLL_CTL_DEL);
+    ReleaseSlot(it->second);
+    fdSlots_.erase(it);
+}
+} // namespace FT
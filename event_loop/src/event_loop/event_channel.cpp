@@ -41,6 +41,18 @@ void EventChannel::Remove()
     eventLoop_->RemoveChannel(fd_);
 }
 
+void EventChannel::SetEdgeReadCallback(EdgeReadCallback cb, std::size_t budget)
+{
+    edgeReadCallback_ = std::move(cb);
+    edgeReadBudget_ = budget;
+    readCallback_ = nullptr;
+    listeningEvents_ |= ECast(EventType::EDGE_EVENT);
+
+    if (addedToLoop_) {
+        Update();
+    }
+}
+
 void EventChannel::EnableReading(bool toUpdate)
 {
     listeningEvents_ |= ECast(EventType::READ_EVENT);
@@ -133,7 +145,9 @@ void EventChannel::HandleEventInner(TimeStamp receivedTime)
 
     if (receivedEvents_ & (EPOLLIN | EPOLLPRI | EPOLLRDHUP)) {
         // LOG_DEBUG("read event in channel %{public}i.", fd_);
-        if (readCallback_ != nullptr) {
+        if (edgeReadCallback_ != nullptr) {
+            HandleEdgeRead(receivedTime);
+        } else if (readCallback_ != nullptr) {
             readCallback_(receivedTime);
         }
     }
@@ -145,4 +159,17 @@ void EventChannel::HandleEventInner(TimeStamp receivedTime)
         }
     }
 }
+
+void EventChannel::HandleEdgeRead(TimeStamp receivedTime)
+{
+    std::size_t calls = 0;
+    while (edgeReadCallback_(receivedTime) == ReadStatus::MORE) {
+        if (edgeReadBudget_ > 0 && ++calls >= edgeReadBudget_) {
+            // no new edge will come for the unread input, so come back by ourselves.
+            readRequeued_ = true;
+            eventLoop_->RequeueChannel(this);
+            return;
+        }
+    }
+}
 } // namespace FT
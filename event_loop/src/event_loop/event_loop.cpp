@@ -15,6 +15,8 @@
 
 #include "event_loop.h"
 
+#include <algorithm>
+#include <limits>
 #include <fcntl.h>
 #include <sys/eventfd.h>
 
@@ -32,41 +34,96 @@ int CreateEventFdOrDie()
 
     return fd;
 }
+
+// the longest time an idle iteration spends on the idle tasks before polling again.
+constexpr TimeType IDLE_TASKS_SLICE = 1000; // 1ms
+// the longest poll while idle tasks are waiting, so the idle tasks which keep adding new ones (or
+// overrun the slice) take at most about half of a quiet loop, instead of making it spin.
+constexpr int IDLE_POLL_TIMEOUT_MS = 1;
+// deadline of the idle tasks without one.
+constexpr TimeStamp NO_IDLE_DEADLINE(std::numeric_limits<TimeType>::max());
+// activeChannels_ reserved up front (the first batch of the epoll poller), so that it doesn't grow
+// the first time a few more channels than usual are ready together, long after the start.
+constexpr std::size_t ACTIVE_CHANNELS_RESERVE = 32;
+// a busy poll window below this is dropped to 0, and a grown one starts from it.
+constexpr uint64_t MIN_BUSY_POLL_NANOS = 10000; // 10us
+
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
 } // namespace detail
 __thread EventLoop *t_currLoop = nullptr; // current thread's event_loop
 
-EventLoop::EventLoop()
+EventLoop::EventLoop() : EventLoop(EventLoopOptions()) {}
+
+EventLoop::EventLoop(const EventLoopOptions &options)
     : tid_(CurrentThread::Tid()),
-      poller_(std::make_unique<EventPoller>(this)),
+      poller_(EventPoller::Create(this, options.pollerBackend)),
       wakeUpFd_(detail::CreateEventFdOrDie()),
       wakeUpChannel_(std::make_unique<EventChannel>(wakeUpFd_.Get(), this)),
-      timerQueue_(std::make_unique<TimerQueue>(this))
+      statsEnabled_(options.enableLoopStats),
+      timerQueue_(std::make_unique<TimerQueue>(this, options.timerQueueBackend,
+          options.enableLoopStats ? &stats_ : nullptr)),
+      offloadExecutor_(options.offloadExecutor)
 {
+    loopNow_ = TimeStamp::Now();
+    activeChannels_.reserve(detail::ACTIVE_CHANNELS_RESERVE);
     if (t_currLoop != nullptr) {
         LOG_FATAL("Construct EventLoop failed: current thread already have a loop(%{public}p)!", &t_currLoop);
     }
 
-    // wakeUpCallback do not need TimeStamp
-    wakeUpChannel_->SetReadCallback([this](TimeStamp) { WakeUpCallback(); });
+    // wakeUpCallback do not need TimeStamp, one read drains the eventfd.
+    wakeUpChannel_->SetEdgeReadCallback([this](TimeStamp) {
+        WakeUpCallback();
+        return ReadStatus::DRAINED;
+    });
     wakeUpChannel_->EnableReading();
     t_currLoop = this;
+
+    for (std::size_t i = 0; i < FUNCTOR_PRIORITY_NUM; ++i) {
+        functorLanes_[i].maxPerIteration = options.functorLanes[i].maxPerIteration;
+        functorLanes_[i].budgetNanos = static_cast<uint64_t>(std::max(options.functorLanes[i].budget, TimeType(0))) *
+            NANO_SECS_PER_MICROSECOND;
+    }
+
+    if (options.stallBudget > 0) {
+        watchdog_ = std::make_unique<LoopWatchdog>(heartbeat_, tid_, options.stallBudget);
+    }
+    if (options.busyPollWindow > 0) {
+        busyPollMaxNanos_ = static_cast<uint64_t>(options.busyPollWindow) * NANO_SECS_PER_MICROSECOND;
+        busyPollWindowNanos_ = busyPollMaxNanos_;
+    }
 }
 
 EventLoop::~EventLoop() noexcept
 {
+    watchdog_ = nullptr;
     wakeUpChannel_->DisableAll();
     Stop();
+
+    // release the functors which have no chance to run.
+    for (auto &lane : functorLanes_) {
+        while (PendingFunctor *node = lane.functors.Pop()) {
+            delete node;
+        }
+    }
+    while (freeFunctorNodes_ != nullptr) {
+        delete std::exchange(freeFunctorNodes_, freeFunctorNodes_->nextFree);
+    }
     t_currLoop = nullptr;
 }
 
 void EventLoop::Stop() noexcept
 {
-    if (!running_) {
+    if (quit_.exchange(true)) {
         return;
     }
 
-    running_ = false;
-
     if (!IsInLoopThread()) {
         WakeUp();
     }
@@ -84,60 +141,182 @@ void EventLoop::UpdateChannel(EventChannel *channel)
 
 void EventLoop::RemoveChannel(int channelFd)
 {
-    RunInLoop([=]() { poller_->RemoveChannel(channelFd); });
+    RunInLoop([this, channelFd]() {
+        poller_->RemoveChannel(channelFd);
+        // the channels are removed before they are destroyed, so the entries left are still valid.
+        for (std::size_t i = undispatchedIndex_; i < activeChannels_.size(); ++i) {
+            if (activeChannels_[i] != nullptr && activeChannels_[i]->Fd() == channelFd) {
+                activeChannels_[i] = nullptr;
+            }
+        }
+        if (!requeuedChannels_.empty()) {
+            requeuedChannels_.erase(std::remove_if(requeuedChannels_.begin(), requeuedChannels_.end(),
+                [channelFd](const auto &requeued) { return requeued.first == channelFd; }),
+                requeuedChannels_.end());
+        }
+    });
 }
 
-void EventLoop::ExecPendingFunctors()
+void EventLoop::RequeueChannel(EventChannel *channel)
 {
     AssertInLoopThread();
+    requeuedChannels_.emplace_back(channel->Fd(), channel);
+}
 
-    executingPendingFunctors_ = true;
-    std::vector<Functor> funcs;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        funcs.swap(pendingFunctors_);
+void EventLoop::MergeRequeuedChannels()
+{
+    for (const auto &requeued : requeuedChannels_) {
+        EventChannel *channel = requeued.second;
+        // skip the ones reported by this poll again, or not reading any more.
+        if (channel->TakeRequeuedRead() && channel->IsReading()) {
+            activeChannels_.emplace_back(channel);
+        }
     }
+    requeuedChannels_.clear();
+}
 
-    for (const auto &func : funcs) {
-        func();
+std::size_t EventLoop::ExecPendingFunctors()
+{
+    AssertInLoopThread();
+
+    executingPendingFunctors_ = true;
+    if (watchdog_ != nullptr) {
+        heartbeat_.SetActivity(LoopPhase::FUNCTORS);
+    }
+    uint64_t startCycles = StatsCycles();
+    functorsLeft_ = false;
+    // only run the functors queued before this call, the ones queued by them will run in the next loop.
+    std::array<MpscQueueNode *, FUNCTOR_PRIORITY_NUM> batchEnds;
+    for (std::size_t i = 0; i < FUNCTOR_PRIORITY_NUM; ++i) {
+        batchEnds[i] = functorLanes_[i].functors.BatchEnd();
     }
+    std::size_t count = 0;
+    std::size_t urgentCount = 0;
+    for (std::size_t i = 0; i < FUNCTOR_PRIORITY_NUM; ++i) {
+        std::size_t executed = ExecFunctorLane(functorLanes_[i], batchEnds[i]);
+        count += executed;
+        if (i != static_cast<std::size_t>(FunctorPriority::BACKGROUND)) {
+            urgentCount += executed;
+        }
+    }
+    pendingFunctorCount_.fetch_sub(count, std::memory_order_relaxed);
     executingPendingFunctors_ = false;
+
+    if (statsEnabled_ && count > 0) {
+        stats_.RecordFunctors(detail::ReadCycles() - startCycles);
+    }
+    return urgentCount;
+}
+
+std::size_t EventLoop::ExecFunctorLane(FunctorLane &lane, MpscQueueNode *batchEnd)
+{
+    uint64_t laneStartCycles = lane.budgetNanos > 0 ? detail::ReadCycles() : 0;
+    std::size_t executed = 0;
+    auto shouldStop = [this, &lane, &executed, laneStartCycles]() {
+        ++executed;
+        bool stop = (lane.maxPerIteration > 0 && executed >= lane.maxPerIteration) ||
+            (lane.budgetNanos > 0 && detail::CyclesToNanos(detail::ReadCycles() - laneStartCycles) >= lane.budgetNanos);
+        functorsLeft_ = functorsLeft_ || stop;
+        return stop;
+    };
+
+    return lane.functors.DrainBatchUntil(batchEnd,
+        [this](PendingFunctor *node) {
+            if (statsEnabled_) {
+                // the counters of different cores may be a bit off, never record a negative delay.
+                uint64_t now = detail::ReadCycles();
+                stats_.RecordQueueDelay(now > node->enqueueCycles ? now - node->enqueueCycles : 0);
+            }
+            node->func();
+            RecycleFunctorNode(node);
+        },
+        shouldStop);
+}
+
+void EventLoop::DispatchActiveChannels(TimeStamp pollTime)
+{
+    uint64_t startCycles = StatsCycles();
+    while (undispatchedIndex_ < activeChannels_.size()) {
+        EventChannel *channel = activeChannels_[undispatchedIndex_++];
+        if (channel == nullptr) {
+            continue;
+        }
+
+        // the channel may be destroyed by its own callbacks, take its fd first.
+        int fd = channel->Fd();
+        if (watchdog_ != nullptr) {
+            heartbeat_.SetActivity(LoopPhase::DISPATCH, fd);
+        }
+        channel->HandleEvent(pollTime);
+        if (statsEnabled_) {
+            uint64_t endCycles = detail::ReadCycles();
+            stats_.RecordDispatch(fd, endCycles - startCycles);
+            startCycles = endCycles;
+        }
+    }
 }
 
-void EventLoop::QueueToLoop(Functor func)
+EventLoop::PendingFunctor *EventLoop::AcquireFunctorNode(Functor &&func)
 {
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pendingFunctors_.push_back(std::move(func));
+    if (freeFunctorNodes_ == nullptr) {
+        return new PendingFunctor(std::move(func));
     }
 
-    if (!IsInLoopThread() || executingPendingFunctors_) {
+    PendingFunctor *node = std::exchange(freeFunctorNodes_, freeFunctorNodes_->nextFree);
+    --freeFunctorNodeCount_;
+    node->func = std::move(func);
+    return node;
+}
+
+void EventLoop::RecycleFunctorNode(PendingFunctor *node)
+{
+    // release the captured objects now rather than when the node is reused.
+    node->func = nullptr;
+    if (freeFunctorNodeCount_ >= MAX_FREE_FUNCTOR_NODES) {
+        delete node;
+        return;
+    }
+
+    node->nextFree = freeFunctorNodes_;
+    freeFunctorNodes_ = node;
+    ++freeFunctorNodeCount_;
+}
+
+void EventLoop::QueueToLoop(Functor func, FunctorPriority priority)
+{
+    bool inLoopThread = IsInLoopThread();
+    pendingFunctorCount_.fetch_add(1, std::memory_order_relaxed);
+    PendingFunctor *node = inLoopThread ? AcquireFunctorNode(std::move(func)) : new PendingFunctor(std::move(func));
+    node->enqueueCycles = StatsCycles();
+    functorLanes_[static_cast<std::size_t>(priority)].functors.Push(node);
+
+    if (!inLoopThread || executingPendingFunctors_) {
         WakeUp();
     }
 }
 
-void EventLoop::RunInLoop(Functor func)
+void EventLoop::RunInLoop(Functor func, FunctorPriority priority)
 {
     if (IsInLoopThread()) {
         func();
     } else {
-        QueueToLoop(std::move(func));
+        QueueToLoop(std::move(func), priority);
     }
 }
 
-TimerId EventLoop::RunAt(Functor func, TimeStamp dstTime)
+TimerId EventLoop::RunAt(Functor func, TimeStamp dstTime, TimeType slack)
 {
-    return timerQueue_->AddTimer(std::move(func), dstTime);
+    return timerQueue_->AddTimer(std::move(func), dstTime, 0, slack);
 }
 
-TimerId EventLoop::RunAfter(Functor func, TimeType delay)
+TimerId EventLoop::RunAfter(Functor func, TimeType delay, TimeType slack)
 {
-    return timerQueue_->AddTimer(std::move(func), TimeAdd(TimeStamp::Now(), delay));
+    return timerQueue_->AddTimer(std::move(func), TimeAdd(Now(), delay), 0, slack);
 }
 
-TimerId EventLoop::RunEvery(Functor func, TimeType interval, TimeType delay)
+TimerId EventLoop::RunEvery(Functor func, TimeType interval, TimeType delay, TimeType slack)
 {
-    return timerQueue_->AddTimer(std::move(func), TimeAdd(TimeStamp::Now(), delay), interval);
+    return timerQueue_->AddTimer(std::move(func), TimeAdd(Now(), delay), interval, slack);
 }
 
 void EventLoop::Cancel(const TimerId &timerId)
@@ -145,24 +324,206 @@ void EventLoop::Cancel(const TimerId &timerId)
     timerQueue_->CancelTimer(timerId);
 }
 
+TimeStamp EventLoop::Now() const
+{
+    return IsInLoopThread() ? loopNow_ : TimeStamp::Now();
+}
+
+TimeStamp EventLoop::NowPrecise()
+{
+    TimeStamp now = TimeStamp::Now();
+    if (IsInLoopThread()) {
+        loopNow_ = now;
+    }
+    return now;
+}
+
+void EventLoop::AddPreSleepHook(Functor hook)
+{
+    RunInLoop([this, hook(std::move(hook))]() mutable { preSleepHooks_.emplace_back(std::move(hook)); });
+}
+
+void EventLoop::RunWhenIdle(Functor task, TimeType deadline)
+{
+    TimeStamp deadlineTime = deadline > 0 ? TimeAdd(Now(), deadline) : detail::NO_IDLE_DEADLINE;
+    if (IsInLoopThread()) {
+        AddIdleTask(std::move(task), deadlineTime);
+    } else {
+        QueueToLoop([this, task(std::move(task)), deadlineTime]() mutable {
+            AddIdleTask(std::move(task), deadlineTime);
+        }, FunctorPriority::BACKGROUND);
+    }
+}
+
+void EventLoop::AddIdleTask(Functor &&task, TimeStamp deadline)
+{
+    if (idleTasks_.empty() || deadline < nextIdleDeadline_) {
+        nextIdleDeadline_ = deadline;
+    }
+    idleTasks_.push_back(IdleTask{std::move(task), deadline});
+}
+
+void EventLoop::RunIdleTasks(bool idle)
+{
+    // the dispatch and the functors ran since the poll, and the slice is measured from here.
+    TimeStamp now = NowPrecise();
+    if (now >= nextIdleDeadline_) {
+        RunOverdueIdleTasks(now);
+    }
+    if (!idle) {
+        return;
+    }
+
+    // the tasks added by the running ones wait for the next idle iteration.
+    TimeStamp sliceEnd = TimeAdd(now, detail::IDLE_TASKS_SLICE);
+    std::size_t count = idleTasks_.size();
+    for (std::size_t i = 0; i < count && !idleTasks_.empty(); ++i) {
+        Functor task = std::move(idleTasks_.front().func);
+        idleTasks_.pop_front();
+        task();
+        if (NowPrecise() >= sliceEnd) {
+            break;
+        }
+    }
+}
+
+void EventLoop::RunOverdueIdleTasks(TimeStamp now)
+{
+    // take the overdue tasks out first, running them may add new ones.
+    nextIdleDeadline_ = detail::NO_IDLE_DEADLINE;
+    std::size_t kept = 0;
+    for (auto &task : idleTasks_) {
+        if (task.deadline <= now) {
+            overdueIdleTasks_.emplace_back(std::move(task.func));
+            continue;
+        }
+        nextIdleDeadline_ = std::min(nextIdleDeadline_, task.deadline);
+        if (&idleTasks_[kept] != &task) {
+            idleTasks_[kept] = std::move(task);
+        }
+        ++kept;
+    }
+    idleTasks_.resize(kept);
+
+    for (auto &task : overdueIdleTasks_) {
+        task();
+    }
+    overdueIdleTasks_.clear();
+}
+
+int EventLoop::IdlePollTimeoutMs() const
+{
+    if (nextIdleDeadline_ == detail::NO_IDLE_DEADLINE) {
+        return detail::IDLE_POLL_TIMEOUT_MS;
+    }
+    // rounded up, a timeout of 0 before the deadline would spin until it.
+    int64_t untilDeadline = TimeDiff(nextIdleDeadline_, loopNow_);
+    if (untilDeadline <= 0) {
+        return 0;
+    }
+    int64_t timeoutMs = (untilDeadline + MICRO_SECS_PER_MILLISECOND - 1) / MICRO_SECS_PER_MILLISECOND;
+    return static_cast<int>(std::min<int64_t>(timeoutMs, detail::IDLE_POLL_TIMEOUT_MS));
+}
+
 void EventLoop::Start()
 {
     AssertInLoopThread();
 
-    running_ = true;
-    while (running_) {
-        std::vector<EventChannel *> activeChannels;
-        TimeStamp pollTime = poller_->PollOnce(activeChannels, -1);
-        for (const auto &channel : activeChannels) {
-            if (channel != nullptr) {
-                channel->HandleEvent(pollTime);
-            }
+    while (!quit_) {
+        activeChannels_.clear();
+        undispatchedIndex_ = 0;
+        uint64_t pollCycles = StatsCycles();
+        bool pollNow = functorsLeft_ || !requeuedChannels_.empty();
+        TimeStamp pollTime;
+        if (pollNow) {
+            pollTime = poller_->PollOnce(activeChannels_, 0);
+        } else if (!idleTasks_.empty()) {
+            // an empty poll is what makes an iteration idle, so only block for a while.
+            pollTime = poller_->PollOnce(activeChannels_, IdlePollTimeoutMs());
+        } else if (busyPollMaxNanos_ == 0) {
+            pollTime = poller_->PollOnce(activeChannels_, -1);
+        } else if (!BusyPoll(pollTime)) {
+            uint64_t blockCycles = detail::ReadCycles();
+            pollTime = poller_->PollOnce(activeChannels_, -1);
+            AdaptBusyPoll(detail::CyclesToNanos(detail::ReadCycles() - blockCycles));
+        }
+        loopNow_ = pollTime;
+        if (statsEnabled_) {
+            stats_.RecordPoll(detail::ReadCycles() - pollCycles);
+        }
+        if (watchdog_ != nullptr) {
+            heartbeat_.BeginIteration();
+        }
+        if (!requeuedChannels_.empty()) {
+            MergeRequeuedChannels();
         }
 
-        ExecPendingFunctors();
+        DispatchActiveChannels(pollTime);
+        std::size_t urgentFunctors = ExecPendingFunctors();
+        if (!idleTasks_.empty()) {
+            RunIdleTasks(activeChannels_.empty() && urgentFunctors == 0);
+        }
+        for (auto &hook : preSleepHooks_) {
+            hook();
+        }
+        if (watchdog_ != nullptr) {
+            heartbeat_.EndIteration();
+        }
     }
 }
 
+bool EventLoop::BusyPoll(TimeStamp &pollTime)
+{
+    if (busyPollWindowNanos_ == 0) {
+        return false;
+    }
+
+    // the producers see a pending wakeup and skip the eventfd write while we spin.
+    // if one is really pending, the first poll reports the eventfd anyway.
+    bool wasPending = wakeUpPending_.exchange(true, std::memory_order_acq_rel);
+    bool found = false;
+    uint64_t start = detail::ReadCycles();
+    do {
+        pollTime = poller_->PollOnce(activeChannels_, 0);
+        if (!activeChannels_.empty() || pendingFunctorCount_.load(std::memory_order_relaxed) > 0 || quit_) {
+            found = true;
+            break;
+        }
+        detail::CpuRelax();
+    } while (detail::CyclesToNanos(detail::ReadCycles() - start) < busyPollWindowNanos_);
+
+    if (!wasPending) {
+        // the acquire exchange makes the functors of the suppressed producers visible to the check below.
+        wakeUpPending_.exchange(false, std::memory_order_acq_rel);
+        found = found || pendingFunctorCount_.load(std::memory_order_relaxed) > 0;
+    }
+
+    auto &counter = found ? busyPolled_ : busyPollMisses_;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return found;
+}
+
+void EventLoop::AdaptBusyPoll(uint64_t blockedNanos)
+{
+    if (blockedNanos > busyPollMaxNanos_) {
+        // idle, even the longest spin would have missed this wakeup.
+        busyPollWindowNanos_ /= 2;
+        if (busyPollWindowNanos_ < detail::MIN_BUSY_POLL_NANOS) {
+            busyPollWindowNanos_ = 0;
+        }
+    } else if (blockedNanos > busyPollWindowNanos_) {
+        // a longer spin would have caught it.
+        busyPollWindowNanos_ = std::min(std::max(busyPollWindowNanos_ * 2, detail::MIN_BUSY_POLL_NANOS),
+            busyPollMaxNanos_);
+    }
+}
+
+WorkStealingExecutor &EventLoop::OffloadExecutor() const
+{
+    // the default executor is only created when a loop without its own executor offloads for the first time.
+    return offloadExecutor_ != nullptr ? *offloadExecutor_ : *WorkStealingExecutor::GetDefault();
+}
+
 bool EventLoop::IsInLoopThread() const
 {
     return CurrentThread::Tid() == tid_;
@@ -182,8 +543,58 @@ void EventLoop::AssertNotInLoopThread() const
     }
 }
 
+WakeUpStats EventLoop::GetWakeUpStats() const
+{
+    WakeUpStats stats;
+    stats.issued = wakeUpsIssued_.load(std::memory_order_relaxed);
+    stats.suppressed = wakeUpsSuppressed_.load(std::memory_order_relaxed);
+    stats.busyPolled = busyPolled_.load(std::memory_order_relaxed);
+    stats.busyPollMisses = busyPollMisses_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+TimerStats EventLoop::GetTimerStats() const
+{
+    return timerQueue_->GetStats();
+}
+
+std::size_t EventLoop::PendingFunctorCount() const
+{
+    return pendingFunctorCount_.load(std::memory_order_relaxed);
+}
+
+const LoopStats &EventLoop::GetLoopStats() const
+{
+    return stats_;
+}
+
+StallStats EventLoop::GetStallStats() const
+{
+    return watchdog_ != nullptr ? watchdog_->GetStats() : StallStats();
+}
+
+void EventLoop::DumpStallStats(std::string &out) const
+{
+    if (watchdog_ != nullptr) {
+        watchdog_->Dump(out);
+    }
+}
+
+void EventLoop::ResetLoopStats()
+{
+    // the histograms have a single writer, so only the loop thread clears them.
+    RunInLoop([this]() { stats_.Reset(); });
+}
+
 void EventLoop::WakeUp()
 {
+    // the loop has not drained the previous wakeup yet, it will see our functor anyway.
+    if (wakeUpPending_.exchange(true, std::memory_order_acq_rel)) {
+        wakeUpsSuppressed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    wakeUpsIssued_.fetch_add(1, std::memory_order_relaxed);
     uint64_t buf = 1;
     int len = TEMP_FAILURE_RETRY(::write(wakeUpChannel_->Fd(), &buf, sizeof(buf)));
     if (OE_UNLIKELY(len != sizeof(buf))) {
@@ -198,6 +609,12 @@ void EventLoop::WakeUpCallback()
     if (OE_UNLIKELY(len != sizeof(buf))) {
         LOG_WARN("should read %{public}lu bytes, but %{public}i read.", sizeof(buf), len);
     }
+
+    // re-arm after the read: clearing it before would let a producer's write be consumed here
+    // while the flag stays set, and then no later producer would wake the loop up again.
+    // the acquire exchange makes the suppressed producers' functors visible to ExecPendingFunctors,
+    // which runs after this callback.
+    wakeUpPending_.exchange(false, std::memory_order_acq_rel);
 }
 
 EventLoop *EventLoop::EventLoopOfCurrThread()
@@ -20,7 +20,12 @@
 namespace FT {
 EventLoopThread::EventLoopThread() : EventLoopThread("OEWMEventLoopThread") {}
 
-EventLoopThread::EventLoopThread(std::string name) : name_(std::move(name)) {}
+EventLoopThread::EventLoopThread(std::string name) : EventLoopThread(std::move(name), EventLoopOptions()) {}
+
+EventLoopThread::EventLoopThread(std::string name, const EventLoopOptions &options,
+    const ThreadOptions &threadOptions)
+    : name_(std::move(name)), options_(options), threadOptions_(threadOptions)
+{}
 
 EventLoopThread::~EventLoopThread() noexcept
 {
@@ -49,7 +54,9 @@ EventLoop *EventLoopThread::Start()
 
 void EventLoopThread::LoopThreadFunc()
 {
-    EventLoop loop;
+    // before the loop exists, so that its memory is allocated under the thread's final policy.
+    ApplyThreadOptions(name_, threadOptions_);
+    EventLoop loop(options_);
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
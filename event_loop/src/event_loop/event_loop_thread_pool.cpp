@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "event_loop_thread_pool.h"
+
+#include "log.h"
+
+namespace FT {
+EventLoopThreadPool::EventLoopThreadPool(std::string name, std::size_t threadNum, const EventLoopOptions &options,
+    const ThreadOptions &threadOptions)
+    : name_(std::move(name)), threadNum_(threadNum), options_(options), threadOptions_(threadOptions)
+{
+    if (threadNum_ == 0) {
+        LOG_FATAL("EventLoopThreadPool %{public}s: threadNum must be greater than 0!", name_.c_str());
+    }
+}
+
+EventLoopThreadPool::~EventLoopThreadPool() noexcept
+{
+    // every EventLoopThread stops and joins its own loop.
+    loops_.clear();
+    threads_.clear();
+}
+
+void EventLoopThreadPool::Start()
+{
+    if (started_.exchange(true)) {
+        LOG_WARN("EventLoopThreadPool %{public}s already started.", name_.c_str());
+        return;
+    }
+
+    threads_.reserve(threadNum_);
+    loops_.reserve(threadNum_);
+    for (std::size_t i = 0; i < threadNum_; ++i) {
+        ThreadOptions threadOptions = threadOptions_;
+        if (threadOptions.spreadCpus && !threadOptions.cpus.empty()) {
+            threadOptions.cpus = {threadOptions_.cpus[i % threadOptions_.cpus.size()]};
+        }
+        auto thread = std::make_unique<EventLoopThread>(name_ + "-" + std::to_string(i), options_, threadOptions);
+        loops_.emplace_back(thread->Start());
+        threads_.emplace_back(std::move(thread));
+    }
+}
+
+EventLoop *EventLoopThreadPool::GetNextLoop(LoopSelectPolicy policy)
+{
+    if (OE_UNLIKELY(loops_.empty())) {
+        LOG_ERROR("EventLoopThreadPool %{public}s is not started!", name_.c_str());
+        return nullptr;
+    }
+
+    if (policy == LoopSelectPolicy::LEAST_LOADED) {
+        return GetLeastLoadedLoop();
+    }
+
+    return loops_[next_.fetch_add(1, std::memory_order_relaxed) % loops_.size()];
+}
+
+EventLoop *EventLoopThreadPool::GetLoopForHash(std::size_t hash) const
+{
+    if (OE_UNLIKELY(loops_.empty())) {
+        LOG_ERROR("EventLoopThreadPool %{public}s is not started!", name_.c_str());
+        return nullptr;
+    }
+
+    return loops_[hash % loops_.size()];
+}
+
+EventLoop *EventLoopThreadPool::GetLeastLoadedLoop()
+{
+    // start from the next loop in turn, so the ties (all idle loops report 0) go round robin.
+    std::size_t start = next_.fetch_add(1, std::memory_order_relaxed) % loops_.size();
+    EventLoop *leastLoaded = loops_[start];
+    std::size_t minLoad = leastLoaded->PendingFunctorCount();
+    for (std::size_t i = 1; i < loops_.size() && minLoad > 0; ++i) {
+        EventLoop *loop = loops_[(start + i) % loops_.size()];
+        std::size_t load = loop->PendingFunctorCount();
+        if (load < minLoad) {
+            minLoad = load;
+            leastLoaded = loop;
+        }
+    }
+    return leastLoaded;
+}
+} // namespace FT
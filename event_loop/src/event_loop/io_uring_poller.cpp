@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io_uring_poller.h"
+
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "types.h"
+#include "event_loop.h"
+
+#include "log.h"
+
+namespace FT {
+namespace detail {
+constexpr uint64_t INTERNAL_USER_DATA = 0; // completions of the poll removals, never a registration.
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t NS_PER_MS = 1000 * 1000;
+
+template <typename T>
+inline T RingLoadAcquire(const T *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+inline void RingStoreRelease(T *p, T v)
+{
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+inline T *RingPtr(void *base, uint32_t offset)
+{
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+} // namespace detail
+
+IoUringPoller::IoUringPoller(EventLoop *eventLoop) : EventPoller(eventLoop) {}
+
+IoUringPoller::~IoUringPoller() noexcept
+{
+    UnmapRings();
+}
+
+std::unique_ptr<IoUringPoller> IoUringPoller::TryCreate(EventLoop *eventLoop)
+{
+    auto poller = std::make_unique<IoUringPoller>(eventLoop);
+    if (!poller->Init()) {
+        return nullptr;
+    }
+    return poller;
+}
+
+bool IoUringPoller::Init()
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = CQ_ENTRIES;
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (fd < 0) {
+        LOG_WARN("io_uring_setup failed: %{public}s.", ErrnoToString(errno).c_str());
+        return false;
+    }
+    ringFd_ = OHOS::UniqueFd(fd);
+
+    // IORING_FEAT_RSRC_TAGS came with multishot poll in 5.13, there is no direct way to probe the latter.
+    constexpr uint32_t requiredFeatures =
+        IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+    if ((params.features & requiredFeatures) != requiredFeatures) {
+        LOG_WARN("io_uring lacks features, required: %{public}x, supported: %{public}x.",
+            requiredFeatures, params.features);
+        return false;
+    }
+
+    return MapRings(params);
+}
+
+bool IoUringPoller::MapRings(const io_uring_params &params)
+{
+    // with IORING_FEAT_SINGLE_MMAP the sq and cq rings share one mapping.
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    sqRingPtr_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_.Get(),
+        IORING_OFF_SQ_RING);
+    if (sqRingPtr_ == MAP_FAILED) {
+        sqRingPtr_ = nullptr;
+        LOG_WARN("mmap io_uring rings failed: %{public}s.", ErrnoToString(errno).c_str());
+        return false;
+    }
+    cqRingPtr_ = sqRingPtr_;
+    cqRingSize_ = 0; // unmapped together with the sq ring.
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_.Get(),
+        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_WARN("mmap io_uring sqes failed: %{public}s.", ErrnoToString(errno).c_str());
+        return false;
+    }
+    sqesPtr_ = static_cast<io_uring_sqe *>(sqes);
+
+    sqEntries_ = params.sq_entries;
+    sq_.head = detail::RingPtr<unsigned>(sqRingPtr_, params.sq_off.head);
+    sq_.tail = detail::RingPtr<unsigned>(sqRingPtr_, params.sq_off.tail);
+    sq_.ringMask = detail::RingPtr<unsigned>(sqRingPtr_, params.sq_off.ring_mask);
+    sq_.array = detail::RingPtr<unsigned>(sqRingPtr_, params.sq_off.array);
+    sq_.sqes = sqesPtr_;
+    sq_.pendingTail = *sq_.tail;
+    // sqe i always sits in slot i of the index array.
+    for (unsigned i = 0; i < sqEntries_; ++i) {
+        sq_.array[i] = i;
+    }
+
+    cq_.head = detail::RingPtr<unsigned>(cqRingPtr_, params.cq_off.head);
+    cq_.tail = detail::RingPtr<unsigned>(cqRingPtr_, params.cq_off.tail);
+    cq_.ringMask = detail::RingPtr<unsigned>(cqRingPtr_, params.cq_off.ring_mask);
+    cq_.cqes = detail::RingPtr<io_uring_cqe>(cqRingPtr_, params.cq_off.cqes);
+    return true;
+}
+
+void IoUringPoller::UnmapRings() noexcept
+{
+    if (sqesPtr_ != nullptr) {
+        ::munmap(sqesPtr_, sqesSize_);
+        sqesPtr_ = nullptr;
+    }
+    if (sqRingPtr_ != nullptr) {
+        ::munmap(sqRingPtr_, sqRingSize_);
+        sqRingPtr_ = nullptr;
+        cqRingPtr_ = nullptr;
+    }
+}
+
+uint64_t IoUringPoller::MakeUserData(int fd, uint32_t generation)
+{
+    // generation is never 0, so this never equals INTERNAL_USER_DATA.
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+int IoUringPoller::Enter(unsigned toSubmit, unsigned minComplete, int timeOutMs)
+{
+    unsigned flags = 0;
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    __kernel_timespec ts = {0, 0};
+    if (minComplete > 0) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        if (timeOutMs >= 0) {
+            ts.tv_sec = timeOutMs / detail::MS_PER_SECOND;
+            ts.tv_nsec = (timeOutMs % detail::MS_PER_SECOND) * detail::NS_PER_MS;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+    }
+
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_.Get(), toSubmit, minComplete, flags,
+        (flags & IORING_ENTER_EXT_ARG) ? &arg : nullptr, (flags & IORING_ENTER_EXT_ARG) ? sizeof(arg) : 0));
+}
+
+unsigned IoUringPoller::PublishSqes()
+{
+    detail::RingStoreRelease(sq_.tail, sq_.pendingTail);
+    return sq_.pendingTail - detail::RingLoadAcquire(sq_.head);
+}
+
+io_uring_sqe *IoUringPoller::GetSqe()
+{
+    if (sq_.pendingTail - detail::RingLoadAcquire(sq_.head) >= sqEntries_) {
+        // too many changes in one iteration, submit them now to make room.
+        int ret = Enter(PublishSqes(), 0, 0);
+        if (ret < 0) {
+            LOG_ERROR("io_uring_enter failed: %{public}s.", ErrnoToString(errno).c_str());
+        }
+        if (sq_.pendingTail - detail::RingLoadAcquire(sq_.head) >= sqEntries_) {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe *sqe = &sq_.sqes[sq_.pendingTail & *sq_.ringMask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sq_.pendingTail;
+    return sqe;
+}
+
+void IoUringPoller::QueuePollAdd(int fd, Registration &registration)
+{
+    io_uring_sqe *sqe = GetSqe();
+    if (OE_UNLIKELY(sqe == nullptr)) {
+        LOG_ERROR("io_uring submission queue is full, can't listen to fd %{public}i.", fd);
+        registration.armed = false;
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    // poll has no edge-triggered mode: a multishot poll only reports the wakeups, which is the edge-triggered
+    // behavior, while a single-shot one armed again after the dispatch keeps the level-triggered one.
+    bool edgeTriggered = (registration.events & static_cast<uint32_t>(EPOLLET)) != 0;
+    sqe->len = edgeTriggered ? IORING_POLL_ADD_MULTI : 0;
+    sqe->poll32_events = registration.events & ~static_cast<uint32_t>(EPOLLET);
+    sqe->user_data = MakeUserData(fd, registration.generation);
+    registration.armed = true;
+}
+
+void IoUringPoller::QueuePollRemove(int fd, Registration &registration)
+{
+    if (!registration.armed) {
+        return;
+    }
+
+    io_uring_sqe *sqe = GetSqe();
+    if (OE_UNLIKELY(sqe == nullptr)) {
+        // the stale completions are dropped by the generation check anyway.
+        LOG_WARN("io_uring submission queue is full, can't cancel the poll of fd %{public}i.", fd);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = MakeUserData(fd, registration.generation);
+    sqe->user_data = detail::INTERNAL_USER_DATA;
+    registration.armed = false;
+}
+
+TimeStamp IoUringPoller::PollOnce(std::vector<EventChannel *> &activeChannels, int timeOutMs)
+{
+    ++pollCount_;
+    unsigned toSubmit = PublishSqes();
+    bool hasCompletions = detail::RingLoadAcquire(cq_.tail) != *cq_.head;
+    if (toSubmit > 0 || !hasCompletions) {
+        // all the registration changes of the last iteration go with the wait.
+        unsigned minComplete = (hasCompletions || timeOutMs == 0) ? 0 : 1;
+        int ret = Enter(toSubmit, minComplete, timeOutMs);
+        if (ret < 0 && errno != EINTR && errno != ETIME && errno != EBUSY) {
+            LOG_WARN("io_uring_enter error: %{public}s.", ErrnoToString(errno).c_str());
+        }
+    }
+
+    auto pollTime = TimeStamp::Now();
+    ReapCompletions(activeChannels);
+    return pollTime;
+}
+
+void IoUringPoller::ReapCompletions(std::vector<EventChannel *> &activeChannels)
+{
+    std::size_t firstActive = activeChannels.size();
+    unsigned head = *cq_.head;
+    unsigned tail = detail::RingLoadAcquire(cq_.tail);
+    for (; head != tail; ++head) {
+        const io_uring_cqe &cqe = cq_.cqes[head & *cq_.ringMask];
+        if (cqe.user_data == detail::INTERNAL_USER_DATA) {
+            continue;
+        }
+
+        int fd = static_cast<int>(cqe.user_data & 0xFFFFFFFFu);
+        uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+        auto it = channels_.find(fd);
+        if (it == channels_.end() || it->second.generation != generation) {
+            continue; // completion of a registration which was updated or removed.
+        }
+
+        auto &registration = it->second;
+        uint32_t events = 0;
+        if (cqe.res < 0) {
+            LOG_WARN("io_uring poll of fd %{public}i failed: %{public}s.", fd, ErrnoToString(-cqe.res).c_str());
+            registration.armed = false;
+            events = EPOLLERR;
+        } else {
+            events = static_cast<uint32_t>(cqe.res);
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                // a single-shot poll is done, or the kernel ended the multishot one (e.g. on cq overflow):
+                // arm a new one, it is submitted by the next PollOnce, after the channel is dispatched.
+                registration.armed = false;
+                QueuePollAdd(fd, registration);
+            }
+        }
+
+        if (registration.lastActivePoll != pollCount_) {
+            registration.lastActivePoll = pollCount_;
+            registration.receivedEvents = events;
+            activeChannels.emplace_back(registration.channel);
+        } else {
+            registration.receivedEvents |= events;
+        }
+    }
+    detail::RingStoreRelease(cq_.head, head);
+
+    for (std::size_t i = firstActive; i < activeChannels.size(); ++i) {
+        EventChannel *channel = activeChannels[i];
+        SetReceivedEvents(channel, channels_[channel->Fd()].receivedEvents);
+    }
+}
+
+void IoUringPoller::UpdateChannel(EventChannel *channel)
+{
+    if (channel == nullptr) {
+        return;
+    }
+
+    eventLoop_->AssertInLoopThread();
+
+    int fd = channel->Fd();
+    if (channel->HasNoEvent()) {
+        eventLoop_->RemoveChannel(fd);
+        return;
+    }
+
+    uint32_t events = ListeningEvents(channel);
+    auto it = channels_.find(fd);
+    if (it != channels_.end() && it->second.armed && it->second.channel == channel && it->second.events == events) {
+        return;
+    }
+
+    if (it == channels_.end()) {
+        it = channels_.emplace(fd, Registration()).first;
+    } else {
+        QueuePollRemove(fd, it->second);
+    }
+
+    auto &registration = it->second;
+    if (++nextGeneration_ == 0) {
+        ++nextGeneration_;
+    }
+    registration.channel = channel;
+    registration.generation = nextGeneration_;
+    registration.events = events;
+    registration.lastActivePoll = 0;
+    QueuePollAdd(fd, registration);
+}
+
+void IoUringPoller::RemoveChannel(int fd)
+{
+    eventLoop_->AssertInLoopThread();
+
+    auto it = channels_.find(fd);
+    if (it == channels_.end()) {
+        LOG_WARN("Can't find channel %{public}i in io_uring poller %{public}i.", fd, ringFd_.Get());
+        return;
+    }
+
+    QueuePollRemove(fd, it->second);
+    channels_.erase(it);
+}
+} // namespace FT
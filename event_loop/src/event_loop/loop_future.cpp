@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_future.h"
+
+#include <climits>
+#include <cstdlib>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "event_loop.h"
+#include "log.h"
+
+namespace FT {
+namespace detail {
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word.");
+
+void PostToLoop(EventLoop *loop, UniqueFunction<void()> &&func)
+{
+    if (loop == nullptr) {
+        func();
+        return;
+    }
+
+    loop->QueueToLoop(std::move(func));
+}
+
+void FutexWait(std::atomic<uint32_t> &word, uint32_t expected)
+{
+    // returns at once with EAGAIN if the word was already changed, the caller checks it again anyway.
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<uint32_t> &word)
+{
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void AbortBrokenFuture()
+{
+    LOG_FATAL("LoopFuture: the task was destroyed without a result!");
+    std::abort();
+}
+} // namespace detail
+} // namespace FT
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_stats.h"
+
+#include <algorithm>
+
+#include "types.h"
+
+namespace FT {
+namespace detail {
+namespace {
+constexpr uint64_t NANOS_PER_SECOND = 1000000000ULL;
+constexpr int64_t CALIBRATE_NANOS = 2000000; // 2ms
+
+uint64_t MonotonicNanos()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * NANOS_PER_SECOND + static_cast<uint64_t>(ts.tv_nsec);
+}
+} // namespace
+
+double NanosPerCycle()
+{
+#if defined(__aarch64__)
+    uint64_t frequency = 0;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    if (frequency != 0) {
+        return static_cast<double>(NANOS_PER_SECOND) / static_cast<double>(frequency);
+    }
+#elif !defined(__x86_64__) && !defined(__i386__)
+    return 1.0;
+#endif
+    // measure the counter against CLOCK_MONOTONIC once.
+    uint64_t startNanos = MonotonicNanos();
+    uint64_t startCycles = ReadCycles();
+    uint64_t nanos = 0;
+    do {
+        nanos = MonotonicNanos() - startNanos;
+    } while (nanos < static_cast<uint64_t>(CALIBRATE_NANOS));
+    uint64_t cycles = ReadCycles() - startCycles;
+    return cycles == 0 ? 1.0 : static_cast<double>(nanos) / static_cast<double>(cycles);
+}
+} // namespace detail
+
+namespace {
+constexpr std::size_t SUB_BUCKET_BITS = 3;
+constexpr uint64_t SUB_BUCKET_NUM = 1ULL << SUB_BUCKET_BITS;
+constexpr std::size_t MAX_EXPONENT = 40;
+constexpr uint64_t NANOS_PER_MICRO = 1000;
+
+void AppendHistogram(std::string &out, const char *name, const HistogramSnapshot &snapshot)
+{
+    constexpr double percentile50 = 0.5;
+    constexpr double percentile90 = 0.9;
+    constexpr double percentile99 = 0.99;
+    constexpr double percentile999 = 0.999;
+    AppendFormat(out, "  %-12s %12lu %10lu %10lu %10lu %10lu %10lu %10lu\n", name, snapshot.count,
+        snapshot.Average() / NANOS_PER_MICRO, snapshot.Percentile(percentile50) / NANOS_PER_MICRO,
+        snapshot.Percentile(percentile90) / NANOS_PER_MICRO, snapshot.Percentile(percentile99) / NANOS_PER_MICRO,
+        snapshot.Percentile(percentile999) / NANOS_PER_MICRO, snapshot.max / NANOS_PER_MICRO);
+}
+} // namespace
+
+uint64_t HistogramSnapshot::Percentile(double quantile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_NUM; ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            return std::min(LatencyHistogram::BucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+std::size_t LatencyHistogram::BucketIndex(uint64_t nanos)
+{
+    if (nanos < SUB_BUCKET_NUM) {
+        return static_cast<std::size_t>(nanos);
+    }
+
+    std::size_t exponent = 63 - static_cast<std::size_t>(__builtin_clzll(nanos));
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_NUM - 1;
+    }
+    std::size_t sub = static_cast<std::size_t>((nanos >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_NUM - 1));
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_NUM + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(std::size_t index)
+{
+    if (index < SUB_BUCKET_NUM) {
+        return index;
+    }
+
+    std::size_t exponent = index / SUB_BUCKET_NUM + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % SUB_BUCKET_NUM;
+    return ((SUB_BUCKET_NUM + sub + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto &bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const
+{
+    HistogramSnapshot snapshot;
+    for (std::size_t i = 0; i < BUCKET_NUM; ++i) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    // count from the buckets themselves, so it always agrees with the percentiles.
+    snapshot.sum = sum_.load(std::memory_order_relaxed);
+    snapshot.max = max_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void LoopStats::RecordDispatch(int fd, uint64_t cycles)
+{
+    uint64_t nanos = detail::CyclesToNanos(cycles);
+    dispatch_.Record(nanos);
+
+    auto &channel = channels_[(fd >= 0 && fd < MAX_TRACKED_FD) ? fd : MAX_TRACKED_FD];
+    channel.count.store(channel.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    channel.sum.store(channel.sum.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+    if (nanos > channel.max.load(std::memory_order_relaxed)) {
+        channel.max.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+void LoopStats::Reset()
+{
+    poll_.Reset();
+    dispatch_.Reset();
+    timers_.Reset();
+    functors_.Reset();
+    queueDelay_.Reset();
+    for (auto &channel : channels_) {
+        channel.count.store(0, std::memory_order_relaxed);
+        channel.sum.store(0, std::memory_order_relaxed);
+        channel.max.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LoopStats::Dump(std::string &out) const
+{
+    AppendFormat(out, "  %-12s %12s %10s %10s %10s %10s %10s %10s\n", "latency(us)", "count", "avg", "p50", "p90",
+        "p99", "p99.9", "max");
+    AppendHistogram(out, "poll", poll_.Snapshot());
+    AppendHistogram(out, "dispatch", dispatch_.Snapshot());
+    AppendHistogram(out, "timers", timers_.Snapshot());
+    AppendHistogram(out, "functors", functors_.Snapshot());
+    AppendHistogram(out, "queue delay", queueDelay_.Snapshot());
+
+    AppendFormat(out, "  %-12s %12s %10s %10s\n", "dispatch fd", "count", "avg(us)", "max(us)");
+    for (int fd = 0; fd <= MAX_TRACKED_FD; ++fd) {
+        const auto &channel = channels_[fd];
+        uint64_t count = channel.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        std::string name = fd < MAX_TRACKED_FD ? std::to_string(fd) : ">=" + std::to_string(MAX_TRACKED_FD);
+        AppendFormat(out, "  %-12s %12lu %10lu %10lu\n", name.c_str(), count,
+            channel.sum.load(std::memory_order_relaxed) / count / NANOS_PER_MICRO,
+            channel.max.load(std::memory_order_relaxed) / NANOS_PER_MICRO);
+    }
+}
+} // namespace FT
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_watchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <sys/syscall.h>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define FT_HAS_BACKTRACE 1
+#endif
+
+#include "log.h"
+
+namespace FT {
+namespace {
+constexpr TimeType NANOS_PER_MICRO = 1000;
+constexpr TimeType MIN_CHECK_INTERVAL = 5000; // 5ms
+constexpr auto STACK_CAPTURE_TIMEOUT = std::chrono::milliseconds(100);
+constexpr int MAX_STACK_DEPTH = 64;
+// a loop which moves to another iteration this often while it is checked is not stalled.
+constexpr int MAX_HEARTBEAT_READS = 8;
+
+enum CaptureState : int {
+    CAPTURE_IDLE = 0,
+    CAPTURE_REQUESTED = 1,
+    CAPTURE_DONE = 2,
+};
+
+// one stack sample at a time for all the watchdogs, serialized by g_captureMutex.
+struct StackCapture {
+    std::atomic<int> state{CAPTURE_IDLE};
+    std::atomic<pid_t> targetTid{-1}; // a late signal from an earlier request must not answer this one.
+    void *frames[MAX_STACK_DEPTH] = {};
+    int depth = 0;
+};
+StackCapture g_capture;
+std::mutex g_captureMutex;
+
+int StackCaptureSignal()
+{
+    // a realtime signal nobody else in the process uses, so it never merges with another one.
+    return SIGRTMIN + 2;
+}
+
+void StackCaptureHandler(int)
+{
+    int savedErrno = errno;
+    if (g_capture.state.load(std::memory_order_acquire) == CAPTURE_REQUESTED &&
+        g_capture.targetTid.load(std::memory_order_relaxed) == static_cast<pid_t>(::syscall(SYS_gettid))) {
+#ifdef FT_HAS_BACKTRACE
+        g_capture.depth = ::backtrace(g_capture.frames, MAX_STACK_DEPTH);
+#endif
+        g_capture.state.store(CAPTURE_DONE, std::memory_order_release);
+    }
+    errno = savedErrno;
+}
+
+void InstallStackCaptureHandler()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+#ifdef FT_HAS_BACKTRACE
+        // the first backtrace() loads the unwinder, which must not happen in the signal handler.
+        void *frame = nullptr;
+        ::backtrace(&frame, 1);
+#endif
+        struct sigaction action {};
+        action.sa_handler = StackCaptureHandler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (::sigaction(StackCaptureSignal(), &action, nullptr) != 0) {
+            LOG_ERROR("Install stack capture handler failed: %{public}s.", ErrnoToString(errno).c_str());
+        }
+    });
+}
+} // namespace
+
+const char *LoopPhaseToString(LoopPhase phase)
+{
+    switch (phase) {
+        case LoopPhase::IDLE:
+            return "idle";
+        case LoopPhase::DISPATCH:
+            return "dispatch";
+        case LoopPhase::FUNCTORS:
+            return "functors";
+        default:
+            return "unknown";
+    }
+}
+
+LoopWatchdog::LoopWatchdog(const LoopHeartbeat &heartbeat, ThreadId loopTid, TimeType budget)
+    : heartbeat_(heartbeat), loopTid_(loopTid), budget_(budget)
+{
+    InstallStackCaptureHandler();
+    thread_ = std::thread([this]() { WatchThreadFunc(); });
+}
+
+LoopWatchdog::~LoopWatchdog() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cond_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LoopWatchdog::WatchThreadFunc()
+{
+    // check a few times per budget, so a stall is reported soon after it exceeds the budget.
+    auto interval = std::chrono::microseconds(std::max(budget_ / 4, MIN_CHECK_INTERVAL));
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cond_.wait_for(lock, interval, [this]() { return stopped_; })) {
+        lock.unlock();
+        Check();
+        lock.lock();
+    }
+}
+
+void LoopWatchdog::Check()
+{
+    // the loop may end its iteration and begin the next one between two reads, so read the iteration
+    // number before and after the start time: when they are equal, the start time belongs to it.
+    uint64_t iteration = heartbeat_.Iteration();
+    uint64_t busySince = 0;
+    for (int reads = 0;; ++reads) {
+        if (reads == MAX_HEARTBEAT_READS) {
+            return;
+        }
+        busySince = heartbeat_.BusySince();
+        uint64_t iterationAfter = heartbeat_.Iteration();
+        if (iterationAfter == iteration) {
+            break;
+        }
+        iteration = iterationAfter;
+    }
+    if (busySince == 0) {
+        return;
+    }
+
+    uint64_t now = detail::ReadCycles();
+    TimeType elapsed = static_cast<TimeType>(detail::CyclesToNanos(now > busySince ? now - busySince : 0)) /
+        NANOS_PER_MICRO;
+    if (iteration == reportedIteration_) {
+        // still the reported stall, only track how long it lasts.
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.longestMicros = std::max(stats_.longestMicros, elapsed);
+        return;
+    }
+    if (elapsed <= budget_) {
+        return;
+    }
+
+    reportedIteration_ = iteration;
+    LoopPhase phase = heartbeat_.Phase();
+    int fd = heartbeat_.Fd();
+    std::string stack = CaptureLoopStack();
+    LOG_ERROR("EventLoop(tid: %{public}d) stalled for %{public}" PRId64 " us (budget %{public}" PRId64
+        " us) in %{public}s, fd: %{public}d, stack:\n%{public}s",
+        loopTid_, elapsed, budget_, LoopPhaseToString(phase), fd, stack.c_str());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.stalls;
+    stats_.longestMicros = std::max(stats_.longestMicros, elapsed);
+    stats_.lastMicros = elapsed;
+    stats_.lastPhase = phase;
+    stats_.lastFd = fd;
+    stats_.lastStack = std::move(stack);
+}
+
+std::string LoopWatchdog::CaptureLoopStack()
+{
+#ifdef FT_HAS_BACKTRACE
+    std::lock_guard<std::mutex> captureLock(g_captureMutex);
+    g_capture.depth = 0;
+    g_capture.targetTid.store(loopTid_, std::memory_order_relaxed);
+    g_capture.state.store(CAPTURE_REQUESTED, std::memory_order_release);
+    if (::syscall(SYS_tgkill, ::getpid(), loopTid_, StackCaptureSignal()) != 0) {
+        g_capture.state.store(CAPTURE_IDLE, std::memory_order_relaxed);
+        return "  <signal failed: " + ErrnoToString(errno) + ">\n";
+    }
+
+    // the loop thread may be in an uninterruptible sleep, do not wait for it forever.
+    auto deadline = std::chrono::steady_clock::now() + STACK_CAPTURE_TIMEOUT;
+    while (g_capture.state.load(std::memory_order_acquire) != CAPTURE_DONE) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            // a late handler finds the state idle and leaves the frames alone.
+            int expected = CAPTURE_REQUESTED;
+            if (g_capture.state.compare_exchange_strong(expected, CAPTURE_IDLE, std::memory_order_acq_rel)) {
+                return "  <stack capture timed out>\n";
+            }
+            break; // the handler just finished.
+        }
+        std::this_thread::yield();
+    }
+
+    std::string stack;
+    char **symbols = ::backtrace_symbols(g_capture.frames, g_capture.depth);
+    for (int i = 0; i < g_capture.depth; ++i) {
+        AppendFormat(stack, "  #%02d %s\n", i, symbols != nullptr ? symbols[i] : "??");
+    }
+    ::free(symbols);
+    g_capture.state.store(CAPTURE_IDLE, std::memory_order_relaxed);
+    return stack;
+#else
+    return "  <stack capture unsupported>\n";
+#endif
+}
+
+StallStats LoopWatchdog::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void LoopWatchdog::Dump(std::string &out) const
+{
+    StallStats stats = GetStats();
+    AppendFormat(out, "  stalls: %lu (budget %ld us), longest: %ld us\n", stats.stalls, budget_,
+        stats.longestMicros);
+    if (stats.stalls == 0) {
+        return;
+    }
+
+    AppendFormat(out, "  last stall: %ld us in %s, fd: %d, stack:\n", stats.lastMicros,
+        LoopPhaseToString(stats.lastPhase), stats.lastFd);
+    out += stats.lastStack;
+}
+} // namespace FT
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ordered_timer_set.h"
+
+#include "timer_wheel.h"
+
+namespace FT {
+std::unique_ptr<TimerStorage> TimerStorage::Create(TimerQueueBackend backend)
+{
+    switch (backend) {
+        case TimerQueueBackend::TIMING_WHEEL:
+            return std::make_unique<TimerWheel>();
+        case TimerQueueBackend::ORDERED_SET:
+        default:
+            return std::make_unique<OrderedTimerSet>();
+    }
+}
+
+void OrderedTimerSet::Insert(Timer *timer)
+{
+    ASSERT(timer != nullptr);
+    if (freeNodes_.empty()) {
+        timerEntries_.insert(std::make_pair(timer->ExpireTime(), timer->Id()));
+        return;
+    }
+
+    auto node = std::move(freeNodes_.back());
+    freeNodes_.pop_back();
+    node.value() = std::make_pair(timer->ExpireTime(), timer->Id());
+    timerEntries_.insert(std::move(node));
+}
+
+void OrderedTimerSet::Remove(Timer *timer)
+{
+    ASSERT(timer != nullptr);
+    RecycleNode(timerEntries_.extract(std::make_pair(timer->ExpireTime(), timer->Id())));
+}
+
+void OrderedTimerSet::RecycleNode(TimerEntrySet::node_type &&node)
+{
+    if (!node.empty() && freeNodes_.size() < MAX_FREE_NODES) {
+        freeNodes_.emplace_back(std::move(node));
+    }
+}
+
+void OrderedTimerSet::TakeExpired(TimeStamp now, std::vector<Timer *> &expired)
+{
+    // TimerId(0, nullptr) is less than any valid TimerId, so the timers expire at @now are included.
+    TimerEntry pivot = std::make_pair(TimeStamp(now.Micros() + 1), TimerId(0, nullptr));
+    auto end = timerEntries_.lower_bound(pivot);
+    for (auto it = timerEntries_.begin(); it != end;) {
+        expired.emplace_back(it->second.timer);
+        RecycleNode(timerEntries_.extract(it++));
+    }
+}
+
+TimeStamp OrderedTimerSet::NextExpireTime() const
+{
+    if (timerEntries_.empty()) {
+        return TimeStamp::Invalid();
+    }
+    return timerEntries_.cbegin()->first;
+}
+
+TimeStamp OrderedTimerSet::NextDeadline() const
+{
+    // only the timers expiring before the earliest deadline found so far can have an earlier one.
+    TimeStamp deadline = TimeStamp::Invalid();
+    for (const auto &entry : timerEntries_) {
+        if (deadline != TimeStamp::Invalid() && deadline < entry.first) {
+            break;
+        }
+        TimeStamp timerDeadline = entry.second.timer->Deadline();
+        if (deadline == TimeStamp::Invalid() || timerDeadline < deadline) {
+            deadline = timerDeadline;
+        }
+    }
+    return deadline;
+}
+} // namespace FT
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_options.h"
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "types.h"
+
+namespace FT {
+namespace {
+constexpr std::size_t MAX_THREAD_NAME_LEN = 15;
+constexpr int MAX_NODE_MASK_BITS = 64 * 16;
+
+bool SetName(const std::string &name)
+{
+    int ret = ::pthread_setname_np(::pthread_self(), name.substr(0, MAX_THREAD_NAME_LEN).c_str());
+    if (ret != 0) {
+        LOG_WARN("Set thread name %{public}s failed: %{public}s.", name.c_str(), ErrnoToString(ret).c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SetAffinity(const std::string &name, const std::vector<int> &cpus)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            LOG_WARN("%{public}s: invalid cpu %{public}d.", name.c_str(), cpu);
+            return false;
+        }
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    int ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (ret != 0) {
+        LOG_WARN("%{public}s: set cpu affinity failed: %{public}s.", name.c_str(), ErrnoToString(ret).c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SetScheduling(const std::string &name, const ThreadOptions &options)
+{
+    if (options.policy == SchedPolicy::OTHER) {
+        sched_param param{};
+        int ret = ::pthread_setschedparam(::pthread_self(), SCHED_OTHER, &param);
+        // the nice value of a thread is set through its tid.
+        if (ret != 0 || ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), options.nice) != 0) {
+            ret = ret != 0 ? ret : errno;
+            LOG_WARN("%{public}s: set nice %{public}d failed: %{public}s.", name.c_str(), options.nice,
+                ErrnoToString(ret).c_str());
+            return false;
+        }
+        return true;
+    }
+
+    sched_param param{};
+    param.sched_priority = options.priority;
+    int policy = options.policy == SchedPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+    int ret = ::pthread_setschedparam(::pthread_self(), policy, &param);
+    if (ret != 0) {
+        LOG_WARN("%{public}s: set %{public}s priority %{public}d failed: %{public}s.", name.c_str(),
+            policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR", options.priority, ErrnoToString(ret).c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SetMemoryPolicy(const std::string &name, const ThreadOptions &options)
+{
+    constexpr int bitsPerWord = 8 * sizeof(unsigned long);
+    unsigned long nodeMask[MAX_NODE_MASK_BITS / bitsPerWord] = {};
+    int mode = MPOL_LOCAL;
+    if (options.memoryPolicy != MemoryPolicy::LOCAL) {
+        for (int node : options.memoryNodes) {
+            if (node < 0 || node >= MAX_NODE_MASK_BITS) {
+                LOG_WARN("%{public}s: invalid memory node %{public}d.", name.c_str(), node);
+                return false;
+            }
+            nodeMask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+        }
+        mode = options.memoryPolicy == MemoryPolicy::BIND ? MPOL_BIND : MPOL_INTERLEAVE;
+    }
+
+    // glibc has no wrapper of set_mempolicy, and libnuma is not worth a dependency for one call.
+    bool hasNodes = mode != MPOL_LOCAL;
+    unsigned long maxNode = hasNodes ? MAX_NODE_MASK_BITS + 1 : 0;
+    if (::syscall(SYS_set_mempolicy, mode, hasNodes ? nodeMask : nullptr, maxNode) != 0) {
+        LOG_WARN("%{public}s: set memory policy failed: %{public}s.", name.c_str(), ErrnoToString(errno).c_str());
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+bool ApplyThreadOptions(const std::string &name, const ThreadOptions &options)
+{
+    bool applied = SetName(name);
+    if (!options.cpus.empty()) {
+        applied = SetAffinity(name, options.cpus) && applied;
+    }
+    if (options.policy != SchedPolicy::INHERIT) {
+        applied = SetScheduling(name, options) && applied;
+    }
+    if (options.memoryPolicy != MemoryPolicy::INHERIT) {
+        applied = SetMemoryPolicy(name, options) && applied;
+    }
+    return applied;
+}
+} // namespace FT
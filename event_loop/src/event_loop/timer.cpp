@@ -21,19 +21,39 @@ namespace FT {
 namespace detail {
 uint64_t GenSequenceId()
 {
+    // 0 is reserved for the released timers.
     static std::atomic<uint64_t> id(0);
-    return id++;
+    return ++id;
 }
 } // namespace detail
 
-Timer::Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval)
+Timer::Timer(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
     : cb_(std::move(callback)),
       expireTime_(expireTime),
       interval_(interval),
+      slack_(slack),
       repeat_(interval > 0),
-      id_(detail::GenSequenceId(), this)
+      seq_(detail::GenSequenceId())
 {}
 
+void Timer::Reset(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
+{
+    cb_ = std::move(callback);
+    expireTime_ = expireTime;
+    interval_ = interval;
+    slack_ = slack;
+    repeat_ = (interval > 0);
+    canceled_ = false;
+    seq_.store(detail::GenSequenceId(), std::memory_order_release);
+}
+
+void Timer::Release()
+{
+    cb_ = nullptr;
+    state_ = TimerState::FREE;
+    seq_.store(0, std::memory_order_release);
+}
+
 void Timer::Execute()
 {
     if (cb_ != nullptr) {
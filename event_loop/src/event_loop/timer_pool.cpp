@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timer_pool.h"
+
+#include "log.h"
+
+namespace FT {
+namespace detail {
+inline uint64_t MakeFreeHead(uint64_t oldHead, uint32_t indexPlusOne)
+{
+    constexpr uint32_t indexBits = 32;
+    uint64_t tag = (oldHead >> indexBits) + 1;
+    return (tag << indexBits) | indexPlusOne;
+}
+} // namespace detail
+
+Timer *TimerPool::Acquire(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
+{
+    uint64_t head = freeHead_.load(std::memory_order_acquire);
+    Timer *timer = nullptr;
+    while (true) {
+        uint32_t indexPlusOne = static_cast<uint32_t>(head & INDEX_MASK);
+        if (indexPlusOne == 0) {
+            if (!Grow(head)) {
+                return nullptr;
+            }
+            head = freeHead_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        timer = TimerAt(indexPlusOne - 1);
+        uint32_t next = timer->poolNext_.load(std::memory_order_relaxed);
+        if (freeHead_.compare_exchange_weak(head, detail::MakeFreeHead(head, next),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    timer->Reset(std::move(callback), expireTime, interval, slack);
+    timer->SetState(TimerState::PENDING);
+    return timer;
+}
+
+void TimerPool::Recycle(Timer *timer)
+{
+    ASSERT(timer != nullptr);
+    timer->Release();
+    timer->prev = nullptr;
+    timer->next = nullptr;
+    PushFreeList(timer, timer);
+}
+
+void TimerPool::PushFreeList(Timer *first, Timer *last)
+{
+    uint64_t head = freeHead_.load(std::memory_order_relaxed);
+    do {
+        last->poolNext_.store(static_cast<uint32_t>(head & INDEX_MASK), std::memory_order_relaxed);
+    } while (!freeHead_.compare_exchange_weak(head, detail::MakeFreeHead(head, first->poolIndex_ + 1),
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool TimerPool::Grow(uint64_t observedHead)
+{
+    std::lock_guard<std::mutex> lock(growMutex_);
+    if (freeHead_.load(std::memory_order_acquire) != observedHead) {
+        // someone has recycled or grown, try again.
+        return true;
+    }
+
+    std::size_t chunkIndex = chunkCount_.load(std::memory_order_relaxed);
+    if (chunkIndex >= MAX_CHUNK_COUNT) {
+        LOG_ERROR("TimerPool is exhausted, %{public}zu timers are in use.", Capacity());
+        return false;
+    }
+
+    auto chunk = std::make_unique<Timer[]>(CHUNK_SIZE);
+    uint32_t base = static_cast<uint32_t>(chunkIndex * CHUNK_SIZE);
+    for (std::size_t i = 0; i < CHUNK_SIZE; ++i) {
+        chunk[i].poolIndex_ = base + static_cast<uint32_t>(i);
+        chunk[i].poolNext_.store(base + static_cast<uint32_t>(i) + 2, std::memory_order_relaxed);
+    }
+    Timer *first = &chunk[0];
+    Timer *last = &chunk[CHUNK_SIZE - 1];
+    chunks_[chunkIndex] = std::move(chunk);
+    chunkCount_.store(chunkIndex + 1, std::memory_order_release);
+    PushFreeList(first, last);
+    return true;
+}
+} // namespace FT
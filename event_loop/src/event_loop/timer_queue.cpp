@@ -24,7 +24,7 @@ namespace FT {
 namespace detail {
 int CreateTimerFd()
 {
-    int fd = TEMP_FAILURE_RETRY(::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    int fd = TEMP_FAILURE_RETRY(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
     if (IsInvalidFd(fd)) {
         LOG_FATAL("Create timerFd error: %{public}s", ErrnoToString(errno).c_str());
     }
@@ -32,25 +32,39 @@ int CreateTimerFd()
     return fd;
 }
 
+void Bump(std::atomic<uint64_t> &counter, uint64_t value = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// absolute time for TFD_TIMER_ABSTIME: a TimeStamp is the steady clock (CLOCK_MONOTONIC) plus
+// TimeStamp::SystemStartTime(), so it converts without reading the clock.
 itimerspec GenerateTimerSpec(TimeStamp dstTime)
 {
     itimerspec newValue{};
 
-    auto diffMicros = TimeDiff(dstTime, TimeStamp::Now());
-    // set minimum diffMicros to 1 us to make sure the timer can be triggered.
-    diffMicros = std::max(decltype(diffMicros)(1), diffMicros);
+    auto monotonicMicros = TimeDiff(dstTime, TimeStamp::SystemStartTime());
+    // an all zero it_value disarms the timer, a time already passed fires at once.
+    monotonicMicros = std::max(decltype(monotonicMicros)(1), monotonicMicros);
 
-    newValue.it_value.tv_sec = diffMicros / MICRO_SECS_PER_SECOND;
-    newValue.it_value.tv_nsec = (diffMicros * NANO_SECS_PER_MICROSECOND) % NANO_SECS_PER_SECOND;
+    newValue.it_value.tv_sec = monotonicMicros / MICRO_SECS_PER_SECOND;
+    newValue.it_value.tv_nsec = (monotonicMicros % MICRO_SECS_PER_SECOND) * NANO_SECS_PER_MICROSECOND;
     return newValue;
 }
+
+// the timers expired by one wakeup which fit in expiredTimers_ before it grows. The timing wheel hands
+// out a whole tick (and its slack) at once, so reserve it rather than growing it late in a steady load.
+constexpr std::size_t EXPIRED_TIMERS_RESERVE = 64;
 } // namespace detail
 
-TimerQueue::TimerQueue(EventLoop *loop)
+TimerQueue::TimerQueue(EventLoop *loop, TimerQueueBackend backend, LoopStats *stats)
     : loop_(loop),
       timerFd_(detail::CreateTimerFd()),
-      timerFdChannel_(std::make_unique<EventChannel>(timerFd_.Get(), loop_))
+      timerFdChannel_(std::make_unique<EventChannel>(timerFd_.Get(), loop_)),
+      timers_(TimerStorage::Create(backend)),
+      stats_(stats)
 {
+    expiredTimers_.reserve(detail::EXPIRED_TIMERS_RESERVE);
     timerFdChannel_->SetReadCallback([this](TimeStamp t) { HandleRead(t); });
     timerFdChannel_->EnableReading();
 }
@@ -60,32 +74,40 @@ TimerQueue::~TimerQueue() noexcept
     timerFdChannel_->DisableAll();
 }
 
-TimerId TimerQueue::AddTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval)
+TimerId TimerQueue::AddTimer(TimerCallback callback, TimeStamp expireTime, TimeType interval, TimeType slack)
 {
-    auto future = loop_->Schedule([=, cb(std::move(callback))]() mutable -> TimerId {
-        auto newTimer = std::make_unique<Timer>(std::move(cb), expireTime, interval);
-        TimerId id = newTimer->Id();
-        AddTimerInLoop(std::move(newTimer));
-        return id;
-    });
-    return future.get();
+    // the TimerId is decided here, only the insertion needs the loop thread, so never wait for it.
+    Timer *newTimer = timerPool_.Acquire(std::move(callback), expireTime, interval, slack);
+    if (newTimer == nullptr) {
+        return TimerId();
+    }
+
+    TimerId id = newTimer->Id();
+    loop_->RunInLoop([this, newTimer]() { AddTimerInLoop(newTimer); });
+    return id;
 }
 
-void TimerQueue::AddTimerInLoop(std::unique_ptr<Timer> &&timer)
+void TimerQueue::AddTimerInLoop(Timer *timer)
 {
     ASSERT(timer != nullptr);
     AssertInLoopThread();
 
-    TimeStamp expireTime = timer->ExpireTime();
-    bool needToResetTimerFd = (timerEntries_.empty() || expireTime < timerEntries_.cbegin()->first);
-
-    TimerId timerId = timer->Id();
-    timerEntries_.insert(std::make_pair(expireTime, timerId));
-    timers_[timerId] = std::move(timer);
+    if (timer->IsCanceled()) {
+        // canceled before its insertion.
+        timerPool_.Recycle(timer);
+        return;
+    }
 
-    if (needToResetTimerFd) {
-        TimerFdReset(expireTime);
+    timer->SetState(TimerState::SCHEDULED);
+    timers_->Insert(timer);
+    if (armedTime_ != TimeStamp::Invalid() && armedTime_ <= timer->Deadline()) {
+        // the armed wakeup is early enough for all the other timers, and now for this one.
+        if (timer->ExpireTime() < armedTime_) {
+            detail::Bump(rearmsSkipped_);
+        }
+        return;
     }
+    TimerFdUpdate();
 }
 
 void TimerQueue::CancelTimer(const TimerId &timerId)
@@ -97,23 +119,27 @@ void TimerQueue::CancelTimerInLoop(const TimerId &timerId)
 {
     AssertInLoopThread();
 
+    // the timer's memory is kept by timerPool_, so the stale TimerId can be checked safely.
     auto timer = timerId.timer;
-    if (timer == nullptr) {
-        return;
-    }
-
-    auto timerEntry = std::make_pair(timer->ExpireTime(), timerId);
-    if (timers_.count(timerId) == 0 || timerEntries_.count(timerEntry) == 0) {
+    if (timer == nullptr || !(timer->Id() == timerId)) {
         return;
     }
 
     LOG_DEBUG("Cancel Timer(id: %{public}lu).", timerId.id);
-    bool needToResetTimerFd = (timerEntry == *timerEntries_.cbegin());
-    timers_.erase(timerId);
-    timerEntries_.erase(timerEntry);
-
-    if (needToResetTimerFd) {
-        TimerFdReset(timerEntries_.cbegin()->first);
+    switch (timer->State()) {
+        case TimerState::SCHEDULED:
+            // leave the timerFd as it is, an early wakeup will rearm it.
+            timers_->Remove(timer);
+            timerPool_.Recycle(timer);
+            break;
+        case TimerState::PENDING:
+            // its insertion is still queued, AddTimerInLoop will recycle it.
+        case TimerState::EXPIRED:
+            // it is being handled by HandleRead, which will recycle it.
+            timer->SetCanceled();
+            break;
+        default:
+            break;
     }
 }
 
@@ -123,62 +149,108 @@ void TimerQueue::AssertInLoopThread()
     loop_->AssertInLoopThread();
 }
 
-std::vector<TimerEntry> TimerQueue::GetExpiredTimers(TimeStamp receivedTime)
-{
-    std::vector<TimerEntry> expiredTimers;
-
-    TimerEntry pivot = std::make_pair(receivedTime, TimerId(0, nullptr));
-    auto it = timerEntries_.lower_bound(pivot);
-    ASSERT(receivedTime <= it->first || it == timerEntries_.cend());
-    std::copy(timerEntries_.begin(), it, std::back_inserter(expiredTimers));
-    timerEntries_.erase(timerEntries_.begin(), it);
-
-    return expiredTimers;
-}
-
 void TimerQueue::HandleRead(TimeStamp receivedTime)
 {
     AssertInLoopThread();
     TimerFdRead();
+    // only a wakeup delayed by the slack saves any.
+    TimeStamp armedTime = armedLate_ ? armedTime_ : TimeStamp::Invalid();
+    armedTime_ = TimeStamp::Invalid();
+    detail::Bump(wakeups_);
 
-    {
-        auto expiredTimers = GetExpiredTimers(receivedTime);
-        for (const auto &[timestamp, timerId] : expiredTimers) {
-            ASSERT(timers_.count(timerId) > 0);
-            auto &timer = timers_.at(timerId);
-            ASSERT(timer != nullptr);
-            if (timer->IsRepeat()) {
-                // restart the timer and insert it back to the timer_queue.
-                timer->Restart(timestamp);
-                timerEntries_.insert(std::make_pair(timer->ExpireTime(), timerId));
-            } else {
-                timers_.erase(timerId);
-            }
+    expiredTimers_.clear();
+    timers_->TakeExpired(receivedTime, expiredTimers_);
+    // without slack, every distinct expire time up to the armed time would have been a wakeup.
+    TimeStamp lastExpireTime = TimeStamp::Invalid();
+    uint64_t saved = 0;
+    for (auto timer : expiredTimers_) {
+        timer->SetState(TimerState::EXPIRED);
+        TimeStamp expireTime = timer->ExpireTime();
+        if (armedTime != TimeStamp::Invalid() && lastExpireTime != TimeStamp::Invalid() &&
+            lastExpireTime < expireTime && expireTime <= armedTime) {
+            ++saved;
+        }
+        lastExpireTime = expireTime;
+    }
+    if (saved > 0) {
+        detail::Bump(wakeupsSaved_, saved);
+    }
 
+    // a timer may cancel itself or the others in this batch.
+    uint64_t startCycles = stats_ != nullptr ? detail::ReadCycles() : 0;
+    for (auto timer : expiredTimers_) {
+        if (!timer->IsCanceled()) {
             timer->Execute();
         }
     }
+    if (stats_ != nullptr) {
+        stats_->RecordTimers(detail::ReadCycles() - startCycles);
+    }
+
+    for (auto timer : expiredTimers_) {
+        if (timer->IsRepeat() && !timer->IsCanceled()) {
+            // restart the timer and insert it back to the timer_queue.
+            timer->Restart(timer->ExpireTime());
+            timer->SetState(TimerState::SCHEDULED);
+            timers_->Insert(timer);
+        } else {
+            timerPool_.Recycle(timer);
+        }
+    }
+    expiredTimers_.clear();
 
-    auto nextExpiredTime = timerEntries_.cbegin()->first;
-    TimerFdReset(nextExpiredTime);
+    TimerFdUpdate();
 }
 
 void TimerQueue::TimerFdRead()
 {
     uint64_t one = 0;
     int len = TEMP_FAILURE_RETRY(::read(timerFd_.Get(), &one, sizeof(one)));
+    if (len < 0 && errno == EAGAIN) {
+        // spurious readiness (pollers may report a stale one), HandleRead just rearms the timerFd.
+        return;
+    }
     if (len != sizeof(one)) {
         LOG_WARN("Read from timerFd(%{public}i) %{public}i bytes, should be %{public}lu bytes.",
             timerFd_.Get(), len, sizeof(one));
     }
 }
 
+void TimerQueue::TimerFdUpdate()
+{
+    auto nextExpireTime = timers_->NextExpireTime();
+    if (nextExpireTime == TimeStamp::Invalid()) {
+        return;
+    }
+
+    if (armedTime_ != TimeStamp::Invalid() && armedTime_ <= nextExpireTime) {
+        return;
+    }
+
+    // wake up as late as the slack of the timers allows, to take the most of them at once.
+    auto nextDeadline = timers_->NextDeadline();
+    TimerFdReset(nextDeadline);
+    armedTime_ = nextDeadline;
+    armedLate_ = nextExpireTime < nextDeadline;
+}
+
 void TimerQueue::TimerFdReset(TimeStamp expireTime)
 {
     auto newValue = detail::GenerateTimerSpec(expireTime);
-    int ret = TEMP_FAILURE_RETRY(::timerfd_settime(timerFd_.Get(), 0, &newValue, nullptr));
+    int ret = TEMP_FAILURE_RETRY(::timerfd_settime(timerFd_.Get(), TFD_TIMER_ABSTIME, &newValue, nullptr));
     if (ret != 0) {
         LOG_FATAL("TimerFd set time error: %{public}s", ErrnoToString(errno).c_str());
     }
+    detail::Bump(rearms_);
+}
+
+TimerStats TimerQueue::GetStats() const
+{
+    TimerStats stats;
+    stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+    stats.rearms = rearms_.load(std::memory_order_relaxed);
+    stats.rearmsSkipped = rearmsSkipped_.load(std::memory_order_relaxed);
+    stats.wakeupsSaved = wakeupsSaved_.load(std::memory_order_relaxed);
+    return stats;
 }
 } // namespace FT
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timer_wheel.h"
+
+namespace FT {
+namespace detail {
+inline void ListInit(TimerListNode *head)
+{
+    head->prev = head;
+    head->next = head;
+}
+
+inline bool ListEmpty(const TimerListNode *head)
+{
+    return head->next == head;
+}
+
+inline void ListPushBack(TimerListNode *head, TimerListNode *node)
+{
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+inline void ListErase(TimerListNode *node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev = nullptr;
+    node->next = nullptr;
+}
+
+// move all nodes of @head to @out and leave @head empty.
+inline void ListTake(TimerListNode *head, TimerListNode *out)
+{
+    ListInit(out);
+    if (ListEmpty(head)) {
+        return;
+    }
+    out->next = head->next;
+    out->prev = head->prev;
+    out->next->prev = out;
+    out->prev->next = out;
+    ListInit(head);
+}
+} // namespace detail
+
+TimerWheel::TimerWheel(TimeStamp startTime, TimeType tickMicros)
+    : startTime_(startTime), tickMicros_(std::max(tickMicros, TimeType(1)))
+{
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        auto &level = levels_[i];
+        level.shift = (i == 0) ? 0 : LEVEL0_BITS + LEVELN_BITS * (i - 1);
+        level.mask = (i == 0) ? ((1u << LEVEL0_BITS) - 1) : ((1u << LEVELN_BITS) - 1);
+        for (auto &slot : level.slots) {
+            detail::ListInit(&slot);
+        }
+    }
+}
+
+uint64_t TimerWheel::TickCeil(TimeStamp time) const
+{
+    auto diff = TimeDiff(time, startTime_);
+    if (diff <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>((diff + tickMicros_ - 1) / tickMicros_);
+}
+
+uint64_t TimerWheel::TickFloor(TimeStamp time) const
+{
+    auto diff = TimeDiff(time, startTime_);
+    if (diff <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(diff / tickMicros_);
+}
+
+TimeStamp TimerWheel::TickTime(uint64_t tick) const
+{
+    return TimeAdd(startTime_, static_cast<TimeType>(tick) * tickMicros_);
+}
+
+void TimerWheel::Insert(Timer *timer)
+{
+    ASSERT(timer != nullptr);
+    timer->wheelTick_ = std::max(TickCeil(timer->ExpireTime()), currentTick_);
+    Place(timer);
+    ++size_;
+}
+
+void TimerWheel::Place(Timer *timer)
+{
+    uint64_t tick = timer->wheelTick_;
+    uint64_t delta = tick - currentTick_;
+    if (delta > MAX_TICKS) {
+        // too far away, park it at the farthest position, TakeExpired will put it back later.
+        delta = MAX_TICKS;
+        tick = currentTick_ + MAX_TICKS;
+        timer->wheelTick_ = tick;
+    }
+
+    int levelIndex = 0;
+    while (levelIndex < LEVEL_COUNT - 1 && delta >= (uint64_t(1) << levels_[levelIndex + 1].shift)) {
+        ++levelIndex;
+    }
+
+    auto &level = levels_[levelIndex];
+    uint32_t slot = static_cast<uint32_t>(tick >> level.shift) & level.mask;
+    timer->wheelLevel_ = static_cast<uint8_t>(levelIndex);
+    timer->wheelSlot_ = static_cast<uint16_t>(slot);
+    detail::ListPushBack(&level.slots[slot], timer);
+    level.occupied[slot / BITMAP_WORD_BITS] |= (uint64_t(1) << (slot % BITMAP_WORD_BITS));
+}
+
+void TimerWheel::Unlink(Timer *timer)
+{
+    auto &level = levels_[timer->wheelLevel_];
+    uint32_t slot = timer->wheelSlot_;
+    detail::ListErase(timer);
+    if (detail::ListEmpty(&level.slots[slot])) {
+        level.occupied[slot / BITMAP_WORD_BITS] &= ~(uint64_t(1) << (slot % BITMAP_WORD_BITS));
+    }
+}
+
+void TimerWheel::Remove(Timer *timer)
+{
+    ASSERT(timer != nullptr && timer->next != nullptr);
+    Unlink(timer);
+    ASSERT(size_ > 0);
+    --size_;
+}
+
+void TimerWheel::Cascade()
+{
+    // called when level 0 wraps around, an upper level is cascaded only if the one below it wrapped too.
+    for (int i = 1; i < LEVEL_COUNT; ++i) {
+        auto &level = levels_[i];
+        uint32_t slot = static_cast<uint32_t>(currentTick_ >> level.shift) & level.mask;
+        detail::TimerListNode pending;
+        detail::ListTake(&level.slots[slot], &pending);
+        level.occupied[slot / BITMAP_WORD_BITS] &= ~(uint64_t(1) << (slot % BITMAP_WORD_BITS));
+        while (!detail::ListEmpty(&pending)) {
+            auto timer = static_cast<Timer *>(pending.next);
+            detail::ListErase(timer);
+            Place(timer);
+        }
+
+        if (slot != 0) {
+            break;
+        }
+    }
+}
+
+void TimerWheel::TakeExpired(TimeStamp now, std::vector<Timer *> &expired)
+{
+    uint64_t nowTick = TickFloor(now);
+    auto &level0 = levels_[0];
+    while (currentTick_ <= nowTick) {
+        uint32_t slot = static_cast<uint32_t>(currentTick_) & level0.mask;
+        if (slot == 0) {
+            Cascade();
+        }
+
+        if (size_ == 0) {
+            currentTick_ = nowTick + 1;
+            break;
+        }
+
+        bool level0Empty = true;
+        for (auto word : level0.occupied) {
+            if (word != 0) {
+                level0Empty = false;
+                break;
+            }
+        }
+        if (level0Empty) {
+            // nothing to expire until the next wrap around, skip to it.
+            currentTick_ = std::min((currentTick_ | level0.mask) + 1, nowTick + 1);
+            continue;
+        }
+
+        auto &head = level0.slots[slot];
+        while (!detail::ListEmpty(&head)) {
+            auto timer = static_cast<Timer *>(head.next);
+            Unlink(timer);
+            uint64_t realTick = TickCeil(timer->ExpireTime());
+            if (realTick > currentTick_) {
+                // it was parked at the farthest position.
+                timer->wheelTick_ = realTick;
+                Place(timer);
+                continue;
+            }
+            --size_;
+            expired.emplace_back(timer);
+        }
+        ++currentTick_;
+    }
+}
+
+int TimerWheel::FindOccupied(const Level &level, uint32_t from) const
+{
+    uint32_t slotCount = level.mask + 1;
+    for (uint32_t dist = 0; dist < slotCount;) {
+        uint32_t slot = (from + dist) & level.mask;
+        uint32_t bit = slot % BITMAP_WORD_BITS;
+        uint64_t word = level.occupied[slot / BITMAP_WORD_BITS] >> bit;
+        if (word != 0) {
+            uint32_t found = dist + static_cast<uint32_t>(__builtin_ctzll(word));
+            return found < slotCount ? static_cast<int>(found) : -1;
+        }
+        // jump to the start of the next word.
+        dist += std::min(BITMAP_WORD_BITS - bit, slotCount);
+    }
+    return -1;
+}
+
+TimeStamp TimerWheel::NextExpireTime() const
+{
+    if (size_ == 0) {
+        return TimeStamp::Invalid();
+    }
+
+    uint64_t nextTick = UINT64_MAX;
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        const auto &level = levels_[i];
+        uint32_t current = static_cast<uint32_t>(currentTick_ >> level.shift) & level.mask;
+        int dist = FindOccupied(level, current);
+        if (dist < 0) {
+            continue;
+        }
+
+        uint64_t tick = 0;
+        if (i == 0) {
+            tick = currentTick_ + static_cast<uint64_t>(dist);
+        } else {
+            // an upper slot is checked when it is cascaded, at the start of its round.
+            uint64_t lowMask = (uint64_t(1) << level.shift) - 1;
+            uint64_t rounds = static_cast<uint64_t>(dist);
+            if (rounds == 0 && (currentTick_ & lowMask) != 0) {
+                // the current slot was cascaded at the start of this round, its timers are a whole lap
+                // away, but the following slots are cascaded sooner. It wraps to the current one at worst.
+                rounds = static_cast<uint64_t>(FindOccupied(level, (current + 1) & level.mask)) + 1;
+            }
+            tick = ((currentTick_ >> level.shift) + rounds) << level.shift;
+        }
+        nextTick = std::min(nextTick, tick);
+    }
+
+    ASSERT(nextTick != UINT64_MAX);
+    return TickTime(nextTick);
+}
+} // namespace FT
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_executor.h"
+
+#include "types.h"
+#include "log.h"
+
+namespace FT {
+namespace {
+// which executor and worker the current thread belongs to, to let the workers push to their own deque.
+__thread WorkStealingExecutor *t_executor = nullptr;
+__thread std::size_t t_workerIndex = 0;
+
+std::size_t DefaultWorkerNum()
+{
+    std::size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(std::size_t workerNum, std::string name) : name_(std::move(name))
+{
+    if (workerNum == 0) {
+        workerNum = DefaultWorkerNum();
+    }
+
+    workers_.reserve(workerNum);
+    for (std::size_t i = 0; i < workerNum; ++i) {
+        workers_.emplace_back(std::make_unique<Worker>());
+    }
+
+    threads_.reserve(workerNum);
+    for (std::size_t i = 0; i < workerNum; ++i) {
+        threads_.emplace_back([this, i]() { WorkerThreadFunc(i); });
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(globalMutex_);
+        running_ = false;
+    }
+    idleCond_.notify_all();
+
+    for (auto &thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    LOG_DEBUG("%{public}s Stopped.", name_.c_str());
+}
+
+const std::shared_ptr<WorkStealingExecutor> &WorkStealingExecutor::GetDefault()
+{
+    static const std::shared_ptr<WorkStealingExecutor> executor = std::make_shared<WorkStealingExecutor>();
+    return executor;
+}
+
+void WorkStealingExecutor::Submit(Task task)
+{
+    if (OE_UNLIKELY(!task)) {
+        return;
+    }
+
+    if (t_executor == this) {
+        auto &worker = *workers_[t_workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(globalMutex_);
+        globalTasks_.emplace_back(std::move(task));
+    }
+
+    // pairs with the idle check in WorkerThreadFunc: either we see the idle worker here,
+    // or it sees this task before going to sleep.
+    pendingTasks_.fetch_add(1, std::memory_order_seq_cst);
+    if (idleWorkers_.load(std::memory_order_seq_cst) > 0) {
+        NotifyOne();
+    }
+}
+
+void WorkStealingExecutor::NotifyOne()
+{
+    {
+        std::lock_guard<std::mutex> lock(globalMutex_);
+    }
+    idleCond_.notify_one();
+}
+
+void WorkStealingExecutor::WorkerThreadFunc(std::size_t index)
+{
+    t_executor = this;
+    t_workerIndex = index;
+
+    Task task;
+    while (true) {
+        if (TakeTask(index, task)) {
+            pendingTasks_.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(globalMutex_);
+        if (!running_ && pendingTasks_.load() == 0) {
+            break;
+        }
+
+        idleWorkers_.fetch_add(1, std::memory_order_seq_cst);
+        idleCond_.wait(lock, [this]() -> bool {
+            return !running_ || pendingTasks_.load(std::memory_order_seq_cst) > 0;
+        });
+        idleWorkers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    t_executor = nullptr;
+}
+
+bool WorkStealingExecutor::TakeTask(std::size_t index, Task &task)
+{
+    return PopLocal(index, task) || PopGlobal(task) || Steal(index, task);
+}
+
+bool WorkStealingExecutor::PopLocal(std::size_t index, Task &task)
+{
+    auto &worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    // LIFO for the owner: the latest task is the most likely to be cache hot.
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingExecutor::PopGlobal(Task &task)
+{
+    std::lock_guard<std::mutex> lock(globalMutex_);
+    if (globalTasks_.empty()) {
+        return false;
+    }
+
+    task = std::move(globalTasks_.front());
+    globalTasks_.pop_front();
+    return true;
+}
+
+bool WorkStealingExecutor::Steal(std::size_t thief, Task &task)
+{
+    std::size_t size = workers_.size();
+    for (std::size_t i = 1; i < size; ++i) {
+        auto &victim = *workers_[(thief + i) % size];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) {
+            continue;
+        }
+
+        // FIFO for the thieves: take the oldest task, away from the owner's end.
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+} // namespace FT
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of the wakeup latency against the cpu cost of EventLoopOptions::busyPollWindow: another
+// thread posts a functor after a fixed gap, again and again, and the functor records how long it took
+// to run. The loop thread's cpu time is read around every run. A window of 0 is the blocking poll.
+// The busy poll is meant for a loop with a dedicated core, on a machine with fewer cores than threads
+// here the spinning loop competes with the poster and the numbers are not meaningful.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr int POSTS = 2000;
+constexpr TimeType WINDOWS[] = {0, 20, 50, 200}; // micro seconds.
+constexpr std::chrono::microseconds GAPS[] = {std::chrono::microseconds(10), std::chrono::microseconds(100),
+    std::chrono::microseconds(1000)};
+
+using Clock = std::chrono::steady_clock;
+
+double ThreadCpuSeconds()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+// spin rather than sleep for the short gaps, a sleep is longer than them.
+void Gap(std::chrono::microseconds gap)
+{
+    auto end = Clock::now() + gap;
+    if (gap >= std::chrono::microseconds(1000)) {
+        std::this_thread::sleep_until(end);
+        return;
+    }
+    while (Clock::now() < end) {
+    }
+}
+
+void Run(TimeType window, std::chrono::microseconds gap)
+{
+    EventLoopOptions options;
+    options.busyPollWindow = window;
+    EventLoopThread loopThread("BusyPollBench", options);
+    EventLoop *loop = loopThread.Start();
+
+    std::vector<int64_t> latencies(POSTS);
+    double cpuStart = loop->Schedule([]() { return ThreadCpuSeconds(); }).Get();
+    auto start = Clock::now();
+    for (int i = 0; i < POSTS; ++i) {
+        Gap(gap);
+        loop->QueueToLoop([&latencies, i, posted(Clock::now())]() {
+            latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - posted).count();
+        });
+    }
+    double cpu = loop->Schedule([]() { return ThreadCpuSeconds(); }).Get() - cpuStart;
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    WakeUpStats stats = loop->GetWakeUpStats();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double ratio) {
+        return latencies[static_cast<std::size_t>(ratio * (latencies.size() - 1))] / 1000;
+    };
+    std::printf("%10ld %10ld %10ld %10ld %10ld %8.0f%% %10lu %10lu\n", static_cast<long>(window),
+        static_cast<long>(gap.count()), at(0.5), at(0.99), at(1.0), cpu / wall * 100, stats.busyPolled,
+        stats.busyPollMisses);
+}
+} // namespace
+
+int main()
+{
+    std::printf("busy_poll_benchmark: %d posts per run, latencies in us, %u cpus\n", POSTS,
+        std::thread::hardware_concurrency());
+    std::printf("%10s %10s %10s %10s %10s %9s %10s %10s\n", "window us", "gap us", "p50", "p99", "max",
+        "loop cpu", "spin hits", "misses");
+    for (auto gap : GAPS) {
+        for (TimeType window : WINDOWS) {
+            Run(window, gap);
+        }
+    }
+    return EXIT_SUCCESS;
+}
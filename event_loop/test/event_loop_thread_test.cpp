@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that an EventLoopThread (and a pool of them) destroyed right after Start() stops and
+// joins its thread: the Stop() may come before the loop thread enters EventLoop::Start().
+// A hang is the failure, the loop below gives up after TIMEOUT.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "event_loop_thread_pool.h"
+
+using namespace FT;
+
+namespace {
+constexpr int ROUNDS = 500;
+constexpr std::size_t POOL_SIZE = 4;
+constexpr auto TIMEOUT = std::chrono::seconds(30);
+} // namespace
+
+int main()
+{
+    std::atomic<int> done{0};
+    std::thread runner([&done]() {
+        for (int i = 0; i < ROUNDS; ++i) {
+            EventLoopThread loopThread("StopTest");
+            loopThread.Start();
+        }
+        for (int i = 0; i < ROUNDS / 10; ++i) {
+            EventLoopThreadPool pool("StopPool", POOL_SIZE);
+            pool.Start();
+        }
+        done = 1;
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (!done && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!done) {
+        std::printf("event_loop_thread_test: a stopped loop kept running\n");
+        std::fflush(stdout);
+        // the runner is stuck in a join, don't wait for it.
+        std::_Exit(EXIT_FAILURE);
+    }
+    runner.join();
+    std::printf("event_loop_thread_test: %d threads and %d pools stopped\n", ROUNDS, ROUNDS / 10);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that every functor lane only runs the functors queued before the iteration, even for the
+// lanes without a limit: a functor queueing itself again in INPUT or PROTOCOL runs once per iteration
+// and can't starve the poller, while other threads keep queueing to the same lanes.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr int PRODUCER_NUM = 2;
+constexpr TimeType TIMER_DELAY = 20 * MICRO_SECS_PER_MILLISECOND;
+constexpr auto TIMER_TIMEOUT = std::chrono::seconds(5);
+
+struct LaneState {
+    EventLoop *loop = nullptr;
+    uint64_t iteration = 0; // bumped before the loop sleeps, loop thread only.
+    uint64_t lastRunIteration[FUNCTOR_PRIORITY_NUM] = {};
+    bool ranTwice = false;
+    std::atomic<bool> stopped{false};
+};
+
+void Requeue(LaneState &state, FunctorPriority priority)
+{
+    auto lane = static_cast<std::size_t>(priority);
+    if (state.lastRunIteration[lane] == state.iteration + 1) {
+        std::printf("  lane %zu ran twice in iteration %lu\n", lane, state.iteration);
+        state.ranTwice = true;
+    }
+    state.lastRunIteration[lane] = state.iteration + 1;
+    if (!state.stopped.load(std::memory_order_relaxed)) {
+        state.loop->QueueToLoop([&state, priority]() { Requeue(state, priority); }, priority);
+    }
+}
+} // namespace
+
+int main()
+{
+    EventLoopThread loopThread("LanesTest");
+    LaneState state;
+    state.loop = loopThread.Start();
+    state.loop->RunInLoop([&state]() {
+        state.loop->AddPreSleepHook([&state]() { ++state.iteration; });
+        Requeue(state, FunctorPriority::INPUT);
+        Requeue(state, FunctorPriority::PROTOCOL);
+    });
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < PRODUCER_NUM; ++i) {
+        producers.emplace_back([&state]() {
+            while (!state.stopped.load(std::memory_order_relaxed)) {
+                state.loop->QueueToLoop([]() {}, FunctorPriority::INPUT);
+                state.loop->QueueToLoop([]() {});
+            }
+        });
+    }
+
+    std::atomic<bool> timerFired{false};
+    state.loop->RunAfter([&timerFired]() { timerFired = true; }, TIMER_DELAY);
+    auto deadline = std::chrono::steady_clock::now() + TIMER_TIMEOUT;
+    while (!timerFired && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    state.stopped = true;
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    bool ranTwice = state.loop->Schedule([&state]() { return state.ranTwice; }).Get();
+
+    std::printf("functor_lanes_test: timer %s, %s\n", timerFired ? "fired" : "starved",
+        ranTwice ? "a functor ran twice in one iteration" : "one run per iteration");
+    return (timerFired && !ranTwice) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
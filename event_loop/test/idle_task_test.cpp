@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that idle tasks don't make the loop spin: an idle task which adds itself again keeps running,
+// but the loop thread stays mostly asleep. Also checks that an idle task runs soon on a quiet loop, and
+// by its deadline on a loop which is never idle.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr auto SPIN_CHECK_TIME = std::chrono::milliseconds(500);
+// the loop thread's cpu time over the wall time, a spinning loop is close to 1.
+constexpr double MAX_CPU_RATIO = 0.5;
+constexpr auto QUIET_LATENCY = std::chrono::milliseconds(20);
+constexpr TimeType DEADLINE = 20 * MICRO_SECS_PER_MILLISECOND;
+constexpr auto DEADLINE_TIMEOUT = std::chrono::milliseconds(500);
+
+using Clock = std::chrono::steady_clock;
+
+double ThreadCpuSeconds()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+struct Reposter {
+    EventLoop *loop = nullptr;
+    std::atomic<bool> stopped{false};
+    std::atomic<uint64_t> runs{0};
+    std::atomic<bool> pending{false};
+
+    void Post()
+    {
+        pending = true;
+        loop->RunWhenIdle([this]() { Run(); });
+    }
+
+    void Run()
+    {
+        pending = false;
+        runs.fetch_add(1, std::memory_order_relaxed);
+        if (!stopped.load(std::memory_order_relaxed)) {
+            Post();
+        }
+    }
+};
+
+// @return: the number of failures.
+int CheckNoSpin(EventLoop *loop)
+{
+    Reposter reposter;
+    reposter.loop = loop;
+    double cpuStart = loop->Schedule([]() { return ThreadCpuSeconds(); }).Get();
+    auto start = Clock::now();
+    loop->RunInLoop([&reposter]() { reposter.Post(); });
+    std::this_thread::sleep_for(SPIN_CHECK_TIME);
+    double cpu = loop->Schedule([]() { return ThreadCpuSeconds(); }).Get() - cpuStart;
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    // let the last one run before the reposter goes away.
+    loop->Schedule([&reposter]() { reposter.stopped = true; }).Wait();
+    while (reposter.pending.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::printf("  self-adding idle task: %lu runs, loop thread cpu %.0f%% of %.0fms\n", reposter.runs.load(),
+        cpu / wall * 100, wall * 1000);
+    int failures = 0;
+    if (reposter.runs.load() == 0) {
+        std::printf("  the idle task never ran\n");
+        ++failures;
+    }
+    if (cpu > wall * MAX_CPU_RATIO) {
+        std::printf("  the loop spun while the idle task was waiting\n");
+        ++failures;
+    }
+    return failures;
+}
+
+// @return: the number of failures.
+int CheckQuietLatency(EventLoop *loop)
+{
+    std::atomic<bool> ran{false};
+    auto start = Clock::now();
+    loop->RunWhenIdle([&ran]() { ran = true; });
+    while (!ran.load() && Clock::now() - start < DEADLINE_TIMEOUT) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto latency = Clock::now() - start;
+    std::printf("  quiet loop: idle task ran after %ldus\n",
+        static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+    return ran.load() && latency < QUIET_LATENCY ? 0 : 1;
+}
+
+// a functor queueing itself again keeps the loop from ever being idle.
+// @return: the number of failures.
+int CheckDeadline(EventLoop *loop)
+{
+    std::atomic<bool> stopped{false};
+    std::atomic<bool> ran{false};
+    struct Busy {
+        static void Run(EventLoop *loop, std::atomic<bool> &stopped)
+        {
+            if (!stopped.load(std::memory_order_relaxed)) {
+                loop->QueueToLoop([loop, &stopped]() { Run(loop, stopped); });
+            }
+        }
+    };
+    loop->RunInLoop([loop, &stopped]() { Busy::Run(loop, stopped); });
+    auto start = Clock::now();
+    loop->RunWhenIdle([&ran]() { ran = true; }, DEADLINE);
+    while (!ran.load() && Clock::now() - start < DEADLINE_TIMEOUT) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stopped = true;
+    loop->Schedule([]() {}).Wait();
+    if (!ran.load()) {
+        std::printf("  busy loop: the idle task missed its deadline\n");
+        return 1;
+    }
+    return 0;
+}
+} // namespace
+
+int main()
+{
+    EventLoopThread loopThread("IdleTaskTest");
+    EventLoop *loop = loopThread.Start();
+    int failures = CheckNoSpin(loop);
+    failures += CheckQuietLatency(loop);
+    failures += CheckDeadline(loop);
+    std::printf("idle_task_test: %d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the steady-state iterations of an EventLoop don't allocate: after a warm-up, the loop thread
+// must do no operator new in idle iterations (woken up by a repeating timer only) nor in busy ones (a
+// self-kicking channel, a timer re-armed and 8 functors queued from the loop thread in every iteration).
+// Runs both timer backends, with and without the loop stats.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr uint64_t WARM_UP_ITERATIONS = 200;
+constexpr uint64_t MEASURED_ITERATIONS = 1000;
+constexpr TimeType IDLE_TIMER_INTERVAL = MICRO_SECS_PER_MILLISECOND;
+constexpr TimeType BUSY_TIMER_DELAY = 10 * MICRO_SECS_PER_MILLISECOND;
+constexpr int BUSY_FUNCTORS = 8;
+constexpr auto PHASE_TIMEOUT = std::chrono::seconds(10);
+
+std::atomic<uint64_t> g_allocs{0};
+thread_local bool t_countAllocs = false; // set in the loop thread only.
+
+// counts the iterations of the loop through a pre-sleep hook, loop thread only but the results.
+struct Phase {
+    uint64_t iterations = 0;
+    uint64_t allocsAfterWarmUp = 0;
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<bool> done{false};
+};
+
+class AllocChecker {
+public:
+    explicit AllocChecker(EventLoop *loop) : loop_(loop)
+    {
+        kickFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (kickFd_ < 0) {
+            std::abort();
+        }
+        loop_->Schedule([this]() {
+            t_countAllocs = true;
+            loop_->AddPreSleepHook([this]() { OnIteration(); });
+            kickChannel_ = std::make_unique<EventChannel>(kickFd_, loop_);
+            kickChannel_->SetReadCallback([this](TimeStamp) { BusyIteration(); });
+            idleTimer_ = loop_->RunEvery([]() {}, IDLE_TIMER_INTERVAL);
+        }).Wait();
+    }
+
+    ~AllocChecker()
+    {
+        loop_->Schedule([this]() {
+            loop_->Cancel(idleTimer_);
+            loop_->Cancel(busyTimer_);
+            kickChannel_->DisableAll();
+            kickChannel_.reset();
+            phase_ = nullptr;
+        }).Wait();
+        ::close(kickFd_);
+    }
+
+    // @return: the allocations of the measured idle iterations, -1 on timeout.
+    int64_t RunIdle()
+    {
+        return RunPhase([]() {});
+    }
+
+    // @return: the allocations of the measured busy iterations, -1 on timeout.
+    int64_t RunBusy()
+    {
+        int64_t allocs = RunPhase([this]() {
+            kickChannel_->EnableReading();
+            Kick();
+        });
+        loop_->Schedule([this]() { kickChannel_->DisableAll(); }).Wait();
+        return allocs;
+    }
+
+private:
+    template <typename Start>
+    int64_t RunPhase(Start start)
+    {
+        Phase phase;
+        loop_->Schedule([this, &phase, &start]() {
+            phase_ = &phase;
+            start();
+        }).Wait();
+        auto deadline = std::chrono::steady_clock::now() + PHASE_TIMEOUT;
+        while (!phase.done.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        loop_->Schedule([this]() { phase_ = nullptr; }).Wait();
+        return phase.done.load() ? static_cast<int64_t>(phase.allocs.load()) : -1;
+    }
+
+    void OnIteration()
+    {
+        if (phase_ == nullptr || phase_->done.load(std::memory_order_relaxed)) {
+            return;
+        }
+        ++phase_->iterations;
+        if (phase_->iterations == WARM_UP_ITERATIONS) {
+            phase_->allocsAfterWarmUp = g_allocs.load();
+        } else if (phase_->iterations == WARM_UP_ITERATIONS + MEASURED_ITERATIONS) {
+            phase_->allocs.store(g_allocs.load() - phase_->allocsAfterWarmUp);
+            phase_->done.store(true);
+        }
+    }
+
+    void Kick()
+    {
+        uint64_t one = 1;
+        if (::write(kickFd_, &one, sizeof(one)) != sizeof(one)) {
+            std::abort();
+        }
+    }
+
+    void BusyIteration()
+    {
+        uint64_t value = 0;
+        if (::read(kickFd_, &value, sizeof(value)) != sizeof(value)) {
+            return;
+        }
+        loop_->Cancel(busyTimer_);
+        busyTimer_ = loop_->RunAfter([]() {}, BUSY_TIMER_DELAY);
+        for (int i = 0; i < BUSY_FUNCTORS; ++i) {
+            auto priority = static_cast<FunctorPriority>(i % FUNCTOR_PRIORITY_NUM);
+            loop_->QueueToLoop([this, i]() { functorRuns_ += i; }, priority);
+        }
+        Kick();
+    }
+
+    EventLoop *loop_ = nullptr;
+    int kickFd_ = -1;
+    // loop thread only.
+    std::unique_ptr<EventChannel> kickChannel_;
+    TimerId idleTimer_;
+    TimerId busyTimer_;
+    Phase *phase_ = nullptr;
+    uint64_t functorRuns_ = 0;
+};
+
+// @return: the number of failures.
+int Check(TimerQueueBackend backend, bool enableStats)
+{
+    EventLoopOptions options;
+    options.timerQueueBackend = backend;
+    options.enableLoopStats = enableStats;
+    EventLoopThread loopThread("AllocTest", options);
+    AllocChecker checker(loopThread.Start());
+
+    const char *name = backend == TimerQueueBackend::ORDERED_SET ? "ordered set" : "timing wheel";
+    int failures = 0;
+    int64_t idleAllocs = checker.RunIdle();
+    int64_t busyAllocs = checker.RunBusy();
+    std::printf("  %s, stats %s: %ld allocations in %lu idle iterations, %ld in %lu busy ones\n", name,
+        enableStats ? "on" : "off", idleAllocs, MEASURED_ITERATIONS, busyAllocs, MEASURED_ITERATIONS);
+    failures += idleAllocs == 0 ? 0 : 1;
+    failures += busyAllocs == 0 ? 0 : 1;
+    return failures;
+}
+} // namespace
+
+// the default operator delete frees with std::free too.
+void *operator new(std::size_t size)
+{
+    if (t_countAllocs) {
+        g_allocs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+int main()
+{
+    int failures = 0;
+    for (auto backend : {TimerQueueBackend::ORDERED_SET, TimerQueueBackend::TIMING_WHEEL}) {
+        failures += Check(backend, true);
+        failures += Check(backend, false);
+    }
+    std::printf("loop_alloc_test: %d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of LoopFuture against std::packaged_task and std::future carrying the same task through
+// EventLoop::RunInLoop: the round trip of one task waited for at once, and a burst of tasks queued
+// before waiting for all of them. Also counts the allocations (operator new of every thread) per task.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <vector>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr int ROUND_TRIPS = 20000;
+constexpr int BURST_SIZE = 1000;
+constexpr int BURSTS = 50;
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<uint64_t> g_allocs{0};
+
+LoopFuture<int> ScheduleLoopFuture(EventLoop *loop, int value)
+{
+    return loop->Schedule([value]() { return value + 1; });
+}
+
+std::future<int> SchedulePackagedTask(EventLoop *loop, int value)
+{
+    std::packaged_task<int()> task([value]() { return value + 1; });
+    std::future<int> future = task.get_future();
+    loop->RunInLoop([task(std::move(task))]() mutable { task(); });
+    return future;
+}
+
+template <typename ScheduleFunc>
+void RoundTrip(const char *name, EventLoop *loop, ScheduleFunc schedule)
+{
+    std::vector<int64_t> samples;
+    samples.reserve(ROUND_TRIPS);
+    uint64_t allocs = g_allocs.load();
+    for (int i = 0; i < ROUND_TRIPS; ++i) {
+        auto start = Clock::now();
+        if (schedule(loop, i).get() != i + 1) {
+            std::abort();
+        }
+        samples.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    double allocsPerTask = static_cast<double>(g_allocs.load() - allocs) / ROUND_TRIPS;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double ratio) { return samples[static_cast<std::size_t>(ratio * (samples.size() - 1))]; };
+    std::printf("%14s %10s %10ld %10ld %10s %12.2f\n", name, "trip", at(0.5), at(0.99), "-", allocsPerTask);
+}
+
+template <typename ScheduleFunc>
+void Burst(const char *name, EventLoop *loop, ScheduleFunc schedule)
+{
+    using Future = decltype(schedule(loop, 0));
+    std::vector<Future> futures;
+    futures.reserve(BURST_SIZE);
+    uint64_t allocs = g_allocs.load();
+    auto start = Clock::now();
+    for (int burst = 0; burst < BURSTS; ++burst) {
+        for (int i = 0; i < BURST_SIZE; ++i) {
+            futures.emplace_back(schedule(loop, i));
+        }
+        for (int i = 0; i < BURST_SIZE; ++i) {
+            if (futures[i].get() != i + 1) {
+                std::abort();
+            }
+        }
+        futures.clear();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double allocsPerTask = static_cast<double>(g_allocs.load() - allocs) / (BURSTS * BURST_SIZE);
+    std::printf("%14s %10s %10s %10s %10.0f %12.2f\n", name, "burst", "-", "-", BURSTS * BURST_SIZE / seconds,
+        allocsPerTask);
+}
+
+// adapts LoopFuture::Get to the std::future spelling used above.
+struct LoopFutureAdapter {
+    LoopFuture<int> future;
+    int get()
+    {
+        return future.Get();
+    }
+};
+} // namespace
+
+// the default operator delete frees with std::free too.
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+int main()
+{
+    std::printf("loop_future_benchmark: %d round trips, %d bursts of %d tasks\n", ROUND_TRIPS, BURSTS, BURST_SIZE);
+    std::printf("%14s %10s %10s %10s %10s %12s\n", "future", "mode", "p50 ns", "p99 ns", "tasks/s", "allocs/task");
+    EventLoopThread loopThread("FutureBench");
+    EventLoop *loop = loopThread.Start();
+    auto loopFuture = [](EventLoop *loop, int value) { return LoopFutureAdapter{ScheduleLoopFuture(loop, value)}; };
+    RoundTrip("LoopFuture", loop, loopFuture);
+    RoundTrip("packaged_task", loop, SchedulePackagedTask);
+    Burst("LoopFuture", loop, loopFuture);
+    Burst("packaged_task", loop, SchedulePackagedTask);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that the futures of EventLoop::Schedule don't block forever when the loop is destroyed
+// with the tasks still pending: they become ready and broken, and Then() drops the continuation.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr auto BLOCK_TIME = std::chrono::milliseconds(50);
+} // namespace
+
+int main()
+{
+    LoopFuture<int> pending;
+    LoopFuture<void> pendingVoid;
+    std::atomic<bool> thenRan{false};
+    std::atomic<bool> waiterWoke{false};
+    std::thread waiter;
+    {
+        EventLoopThread loopThread("FutureTest");
+        EventLoop *loop = loopThread.Start();
+        // keep the loop busy until the tasks below are queued, then quit it before they run.
+        std::atomic<bool> blocking{false};
+        loop->QueueToLoop([loop, &blocking]() {
+            blocking = true;
+            std::this_thread::sleep_for(BLOCK_TIME);
+            loop->Stop();
+        });
+        while (!blocking) {
+            std::this_thread::yield();
+        }
+        pending = loop->Schedule([]() { return 1; });
+        pendingVoid = loop->Schedule([]() {});
+        loop->Schedule([]() { return 2; }).Then(nullptr, [&thenRan](int) { thenRan = true; });
+        waiter = std::thread([&pendingVoid, &waiterWoke]() {
+            pendingVoid.Wait();
+            waiterWoke = true;
+        });
+    }
+    waiter.join();
+    pending.Wait();
+
+    bool ok = waiterWoke && pending.IsBroken() && pendingVoid.IsBroken() && !thenRan;
+    std::printf("loop_future_test: waiter %s, future %s, continuation %s\n", waiterWoke ? "woke" : "blocked",
+        pending.IsBroken() ? "broken" : "not broken", thenRan ? "ran" : "dropped");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Contention benchmark of the functor queue: MpscQueue against the mutex and vector swap which
+// QueueToLoop used before, with 1 to 16 producer threads and one consumer draining in batches.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+
+using namespace FT;
+
+namespace {
+constexpr uint64_t TOTAL_PUSHES = 1 << 21;
+constexpr int PRODUCER_COUNTS[] = {1, 2, 4, 8, 16};
+
+struct BenchNode : MpscQueueNode {
+    uint64_t value = 0;
+};
+
+// the old QueueToLoop path: push_back under the lock, the consumer swaps the whole vector out.
+class MutexQueue {
+public:
+    void Push(BenchNode *node)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(node);
+    }
+
+    template <typename Handler>
+    std::size_t DrainBatch(Handler &&handler)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            scratch_.swap(pending_);
+        }
+        for (BenchNode *node : scratch_) {
+            handler(node);
+        }
+        std::size_t count = scratch_.size();
+        scratch_.clear();
+        return count;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<BenchNode *> pending_;
+    std::vector<BenchNode *> scratch_;
+};
+
+// @return: nanoseconds per push, from the first push to the last node drained.
+template <typename Queue>
+double Run(int producerNum)
+{
+    Queue queue;
+    uint64_t perProducer = TOTAL_PUSHES / static_cast<uint64_t>(producerNum);
+    uint64_t total = perProducer * static_cast<uint64_t>(producerNum);
+    auto nodes = std::make_unique<BenchNode[]>(total);
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerNum; ++p) {
+        producers.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            BenchNode *begin = &nodes[static_cast<uint64_t>(p) * perProducer];
+            for (uint64_t i = 0; i < perProducer; ++i) {
+                queue.Push(begin + i);
+            }
+        });
+    }
+
+    uint64_t drained = 0;
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    while (drained < total) {
+        std::size_t count = queue.DrainBatch([&sum](BenchNode *node) { sum += node->value; });
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        drained += count;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    if (sum != 0) {
+        std::abort();
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        static_cast<double>(total);
+}
+} // namespace
+
+int main()
+{
+    std::printf("mpsc_queue_benchmark: %lu pushes, %u cores\n", TOTAL_PUSHES, std::thread::hardware_concurrency());
+    std::printf("%10s %14s %14s %8s\n", "producers", "mutex ns/op", "mpsc ns/op", "speedup");
+    for (int producerNum : PRODUCER_COUNTS) {
+        double mutexNs = Run<MutexQueue>(producerNum);
+        double mpscNs = Run<MpscQueue<BenchNode>>(producerNum);
+        std::printf("%10d %14.1f %14.1f %7.2fx\n", producerNum, mutexNs, mpscNs, mutexNs / mpscNs);
+    }
+    return EXIT_SUCCESS;
+}
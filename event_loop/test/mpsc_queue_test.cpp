@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Stress test of MpscQueue::DrainBatchUntil with several producers: every node comes out once and
+// in the order of its producer, a drain never goes past the batch it started with even when the
+// handler pushes again, and a drain stopped early leaves the rest for the next one.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+
+using namespace FT;
+
+namespace {
+constexpr int PRODUCER_NUM = 4;
+constexpr uint32_t NODES_PER_PRODUCER = 200000;
+constexpr uint32_t STOP_EVERY = 7; // stop a drain early after this many nodes, now and then.
+
+struct TestNode : MpscQueueNode {
+    int producer = 0;
+    uint32_t seq = 0;
+};
+
+class DrainChecker {
+public:
+    DrainChecker() : nodes_(std::make_unique<TestNode[]>(PRODUCER_NUM * NODES_PER_PRODUCER)) {}
+
+    // @return: the number of failures.
+    int Run()
+    {
+        std::atomic<int> started{0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCER_NUM; ++p) {
+            producers.emplace_back([this, p, &started]() {
+                started.fetch_add(1);
+                for (uint32_t i = 0; i < NODES_PER_PRODUCER; ++i) {
+                    TestNode *node = &nodes_[p * NODES_PER_PRODUCER + i];
+                    node->producer = p;
+                    node->seq = i;
+                    // counted before the push, so a batch never holds more than reserved_ says.
+                    reserved_.fetch_add(1, std::memory_order_release);
+                    queue_.Push(node);
+                }
+            });
+        }
+
+        // the requeue node is pushed again by the handler every time it comes out, like a functor
+        // queueing itself, so the queue keeps going back to the stub.
+        queue_.Push(&requeue_);
+        uint64_t received = 0;
+        uint64_t total = static_cast<uint64_t>(PRODUCER_NUM) * NODES_PER_PRODUCER;
+        uint64_t drains = 0;
+        while ((received < total || started.load() < PRODUCER_NUM) && failures_ == 0) {
+            ++drains;
+            received += Drain(drains, received);
+        }
+
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        while (failures_ == 0 && received < total) {
+            received += Drain(++drains, received);
+        }
+        std::printf("  %lu nodes in %lu drains, requeue node handled %lu times\n", received, drains, requeueRuns_);
+        return failures_;
+    }
+
+private:
+    // @return: the number of producer nodes handled.
+    uint64_t Drain(uint64_t drain, uint64_t received)
+    {
+        uint64_t handled = 0;
+        bool requeueSeen = false;
+        uint32_t count = 0;
+        bool stopEarly = (drain % 3 == 0);
+        MpscQueueNode *batchEnd = queue_.BatchEnd();
+        uint64_t reserved = reserved_.load(std::memory_order_acquire);
+        queue_.DrainBatchUntil(batchEnd, [&](TestNode *node) {
+            ++count;
+            if (node == &requeue_) {
+                if (requeueSeen) {
+                    std::printf("  drain %lu went past its batch, the requeue node came out twice\n", drain);
+                    ++failures_;
+                }
+                requeueSeen = true;
+                ++requeueRuns_;
+                queue_.Push(&requeue_);
+                return;
+            }
+            if (node->seq != nextSeq_[node->producer]) {
+                std::printf("  producer %d: expected %u, got %u\n", node->producer, nextSeq_[node->producer],
+                    node->seq);
+                ++failures_;
+            }
+            nextSeq_[node->producer] = node->seq + 1;
+            ++handled;
+        }, [&]() { return stopEarly && count % STOP_EVERY == 0; });
+        if (received + handled > reserved) {
+            std::printf("  drain %lu went past its batch: %lu nodes handled, %lu pushed before it\n", drain,
+                received + handled, reserved);
+            ++failures_;
+        }
+        return handled;
+    }
+
+    MpscQueue<TestNode> queue_;
+    std::unique_ptr<TestNode[]> nodes_;
+    TestNode requeue_;
+    std::atomic<uint64_t> reserved_{0};
+    uint32_t nextSeq_[PRODUCER_NUM] = {};
+    uint64_t requeueRuns_ = 0;
+    int failures_ = 0;
+};
+} // namespace
+
+int main()
+{
+    int failures = DrainChecker().Run();
+    std::printf("mpsc_queue_test: %d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of the protocol dispatch latency of a loop which also composes a frame every 16ms:
+// the compose runs inline in the loop, or in the WorkStealingExecutor through EventLoop::Offload
+// with only its result handed back to the loop. A client thread queues a small request every 500us,
+// the latency is from the QueueToLoop to the request running in the loop.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "event_loop_thread.h"
+#include "work_stealing_executor.h"
+
+using namespace FT;
+
+namespace {
+constexpr TimeType FRAME_INTERVAL = 16 * MICRO_SECS_PER_MILLISECOND;
+constexpr auto REQUEST_INTERVAL = std::chrono::microseconds(500);
+constexpr auto RUN_TIME = std::chrono::seconds(2);
+constexpr std::size_t FRAME_PIXELS = 1920 * 1080;
+constexpr int COMPOSE_PASSES = 2; // layers blended into the frame.
+
+using Clock = std::chrono::steady_clock;
+
+// blends COMPOSE_PASSES layers into @frame, a few ms of pure CPU work like a software compose.
+uint32_t Compose(std::vector<uint32_t> &frame, const std::vector<uint32_t> &layer)
+{
+    for (int pass = 0; pass < COMPOSE_PASSES; ++pass) {
+        for (std::size_t i = 0; i < frame.size(); ++i) {
+            uint32_t src = layer[i] + static_cast<uint32_t>(pass);
+            frame[i] = ((frame[i] >> 1) & 0x7f7f7f7f) + ((src >> 1) & 0x7f7f7f7f);
+        }
+    }
+    return frame[frame.size() / 2];
+}
+
+struct Result {
+    std::vector<int64_t> latencies; // micro seconds.
+    int frames = 0;
+};
+
+Result Run(bool offload)
+{
+    Result result;
+    std::vector<uint32_t> frame(FRAME_PIXELS, 0);
+    std::vector<uint32_t> layer(FRAME_PIXELS, 0x80402010);
+    bool composing = false; // loop thread only.
+    std::atomic<uint32_t> checksum{0};
+    std::vector<int64_t> latencies;
+    latencies.reserve(static_cast<std::size_t>(RUN_TIME / REQUEST_INTERVAL));
+
+    EventLoopOptions options;
+    options.offloadExecutor = std::make_shared<WorkStealingExecutor>();
+    EventLoopThread loopThread("OffloadBench", options);
+    EventLoop *loop = loopThread.Start();
+    TimerId frameTimer = loop->RunEvery([&]() {
+        if (!offload) {
+            checksum += Compose(frame, layer);
+            ++result.frames;
+            return;
+        }
+        if (composing) {
+            return; // the last frame is still being composed, skip this one like a real compositor.
+        }
+        composing = true;
+        loop->Offload([&frame, &layer]() { return Compose(frame, layer); }, [&](uint32_t sum) {
+            checksum += sum;
+            composing = false;
+            ++result.frames;
+        });
+    }, FRAME_INTERVAL);
+
+    auto end = Clock::now() + RUN_TIME;
+    while (Clock::now() < end) {
+        auto posted = Clock::now();
+        loop->QueueToLoop([&latencies, posted]() {
+            auto latency = Clock::now() - posted;
+            latencies.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+        });
+        std::this_thread::sleep_for(REQUEST_INTERVAL);
+    }
+
+    // stop composing and collect everything in the loop, then let the compose in flight finish
+    // before the loop goes away.
+    loop->Schedule([&]() {
+        loop->Cancel(frameTimer);
+        result.latencies = std::move(latencies);
+    }).Get();
+    while (loop->Schedule([&composing]() { return composing; }).Get()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+void Report(const char *name, const Result &result)
+{
+    const auto &samples = result.latencies;
+    auto at = [&samples](double ratio) { return samples[static_cast<std::size_t>(ratio * (samples.size() - 1))]; };
+    std::printf("%10s %8zu %8d %10ld %10ld %10ld\n", name, samples.size(), result.frames, at(0.5), at(0.99),
+        samples.back());
+}
+} // namespace
+
+int main()
+{
+    std::vector<uint32_t> frame(FRAME_PIXELS, 0);
+    std::vector<uint32_t> layer(FRAME_PIXELS, 1);
+    auto start = Clock::now();
+    volatile uint32_t sink = Compose(frame, layer);
+    (void)sink;
+    auto composeUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    std::printf("offload_benchmark: compose of %ldus every %ldms, %u cores, request latency in us\n", composeUs,
+        FRAME_INTERVAL / MICRO_SECS_PER_MILLISECOND, std::thread::hardware_concurrency());
+    std::printf("%10s %8s %8s %10s %10s %10s\n", "compose", "requests", "frames", "p50", "p99", "max");
+    Report("inline", Run(false));
+    Report("offload", Run(true));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of the poller backends with thousands of idle channels and a few hot ones, and with 10k
+// channels which are all ready: the cost of registering and removing all of them from the loop, and
+// the events dispatched per second while the hot channels are always ready (each callback reads its
+// eventfd and writes it again).
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "event_loop_thread.h"
+#include "io_uring_poller.h"
+
+using namespace FT;
+
+namespace {
+struct Setup {
+    std::size_t idleChannels;
+    std::size_t hotChannels;
+};
+constexpr Setup SETUPS[] = {{5000, 8}, {0, 10000}};
+constexpr auto DISPATCH_TIME = std::chrono::seconds(1);
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    int64_t registerUs = 0;
+    int64_t removeUs = 0;
+    double eventsPerSecond = 0;
+    double iterationsPerSecond = 0;
+};
+
+class PollerBench {
+public:
+    PollerBench(EventLoop *loop, const Setup &setup) : loop_(loop), idleChannels_(setup.idleChannels)
+    {
+        for (std::size_t i = 0; i < setup.idleChannels + setup.hotChannels; ++i) {
+            int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd < 0) {
+                std::abort();
+            }
+            fds_.emplace_back(fd);
+        }
+    }
+
+    ~PollerBench()
+    {
+        for (int fd : fds_) {
+            ::close(fd);
+        }
+    }
+
+    Result Run()
+    {
+        Result result;
+        auto start = Clock::now();
+        loop_->Schedule([this]() { Register(); }).Get();
+        // the io_uring backend submits the registrations with the next wait, count it.
+        loop_->Schedule([]() {}).Get();
+        result.registerUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+        std::atomic<uint64_t> iterations{0};
+        loop_->Schedule([this, &iterations]() {
+            loop_->AddPreSleepHook([&iterations]() {
+                iterations.store(iterations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            });
+            for (std::size_t i = idleChannels_; i < fds_.size(); ++i) {
+                Kick(fds_[i]);
+            }
+        }).Get();
+        uint64_t events = events_.load();
+        uint64_t iterationsBefore = iterations.load();
+        start = Clock::now();
+        std::this_thread::sleep_for(DISPATCH_TIME);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.eventsPerSecond = static_cast<double>(events_.load() - events) / seconds;
+        result.iterationsPerSecond = static_cast<double>(iterations.load() - iterationsBefore) / seconds;
+
+        start = Clock::now();
+        loop_->Schedule([this]() { Remove(); }).Get();
+        loop_->Schedule([]() {}).Get();
+        result.removeUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        return result;
+    }
+
+private:
+    static void Kick(int fd)
+    {
+        uint64_t one = 1;
+        if (::write(fd, &one, sizeof(one)) != sizeof(one)) {
+            std::abort();
+        }
+    }
+
+    void Register()
+    {
+        for (std::size_t i = 0; i < fds_.size(); ++i) {
+            int fd = fds_[i];
+            auto channel = std::make_unique<EventChannel>(fd, loop_);
+            if (i >= idleChannels_) {
+                channel->SetReadCallback([this, fd](TimeStamp) {
+                    uint64_t value = 0;
+                    if (::read(fd, &value, sizeof(value)) == sizeof(value)) {
+                        events_.store(events_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                        Kick(fd);
+                    }
+                });
+            }
+            channel->EnableReading();
+            channels_.emplace_back(std::move(channel));
+        }
+    }
+
+    void Remove()
+    {
+        for (auto &channel : channels_) {
+            channel->DisableAll();
+        }
+        channels_.clear();
+    }
+
+    EventLoop *loop_ = nullptr;
+    std::size_t idleChannels_ = 0;
+    std::vector<int> fds_;
+    std::vector<std::unique_ptr<EventChannel>> channels_; // loop thread only.
+    std::atomic<uint64_t> events_{0};                     // written by the loop thread only.
+};
+
+void Report(const char *name, const Setup &setup, const Result &result)
+{
+    std::printf("%10s %6zu %6zu %12ld %12ld %14.0f %14.0f\n", name, setup.idleChannels, setup.hotChannels,
+        result.registerUs, result.removeUs, result.eventsPerSecond, result.iterationsPerSecond);
+}
+} // namespace
+
+int main()
+{
+    std::printf("poller_benchmark:\n");
+    std::printf("%10s %6s %6s %12s %12s %14s %14s\n", "backend", "idle", "hot", "register us", "remove us",
+        "events/s", "iterations/s");
+    bool uringSupported = true;
+    for (const Setup &setup : SETUPS) {
+        {
+            EventLoopOptions options;
+            options.pollerBackend = PollerBackend::EPOLL;
+            EventLoopThread loopThread("PollerBench", options);
+            EventLoop *loop = loopThread.Start();
+            Report("epoll", setup, PollerBench(loop, setup).Run());
+        }
+        if (!uringSupported) {
+            continue;
+        }
+        EventLoopOptions options;
+        options.pollerBackend = PollerBackend::IO_URING;
+        EventLoopThread loopThread("PollerBench", options);
+        EventLoop *loop = loopThread.Start();
+        uringSupported = loop->Schedule([loop]() { return IoUringPoller::TryCreate(loop) != nullptr; }).Get();
+        if (!uringSupported) {
+            std::printf("%10s not supported by the kernel\n", "io_uring");
+            continue;
+        }
+        Report("io_uring", setup, PollerBench(loop, setup).Run());
+    }
+    return EXIT_SUCCESS;
+}
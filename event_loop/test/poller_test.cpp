@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks that both poller backends keep the epoll semantics of the channels: a level-triggered
+// channel which reads one byte per callback is reported again until its pipe is empty (io_uring
+// re-arms its single-shot poll), and an edge-triggered one with a read budget gets all of its
+// input through RequeueChannel without a new edge. Also checks that a channel removed and destroyed by an
+// earlier callback of the same batch is not dispatched any more.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+#include "event_loop_thread.h"
+#include "io_uring_poller.h"
+
+using namespace FT;
+
+namespace {
+constexpr int BYTES = 100;
+constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+class Pipe {
+public:
+    Pipe()
+    {
+        if (::pipe2(fds_, O_NONBLOCK | O_CLOEXEC) != 0) {
+            std::abort();
+        }
+    }
+    ~Pipe()
+    {
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+
+    int ReadFd() const
+    {
+        return fds_[0];
+    }
+    bool Fill() const
+    {
+        char buf[BYTES] = {};
+        return ::write(fds_[1], buf, BYTES) == BYTES;
+    }
+
+private:
+    int fds_[2] = {-1, -1};
+};
+
+bool WaitFor(const std::atomic<int> &count, int expected)
+{
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (count.load() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // give a wrong extra callback the chance to show up.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return count.load() == expected;
+}
+
+// @return: the number of failures.
+int CheckBackend(const char *name, EventLoop *loop)
+{
+    int failures = 0;
+    Pipe levelPipe;
+    std::atomic<int> levelReads{0};
+    EventChannel level(levelPipe.ReadFd(), loop);
+    level.SetReadCallback([&levelPipe, &levelReads](TimeStamp) {
+        char c = 0;
+        if (::read(levelPipe.ReadFd(), &c, 1) == 1) {
+            ++levelReads;
+        }
+    });
+
+    Pipe edgePipe;
+    std::atomic<int> edgeReads{0};
+    EventChannel edge(edgePipe.ReadFd(), loop);
+    edge.SetEdgeReadCallback([&edgePipe, &edgeReads](TimeStamp) {
+        char c = 0;
+        if (::read(edgePipe.ReadFd(), &c, 1) != 1) {
+            return ReadStatus::DRAINED;
+        }
+        ++edgeReads;
+        return ReadStatus::MORE;
+    }, 1);
+
+    loop->Schedule([&level, &edge]() {
+        level.EnableReading();
+        edge.EnableReading();
+    }).Wait();
+    if (!levelPipe.Fill() || !edgePipe.Fill()) {
+        std::abort();
+    }
+    if (!WaitFor(levelReads, BYTES)) {
+        std::printf("  %s: level-triggered channel read %d of %d bytes\n", name, levelReads.load(), BYTES);
+        ++failures;
+    }
+    if (!WaitFor(edgeReads, BYTES)) {
+        std::printf("  %s: edge-triggered channel read %d of %d bytes\n", name, edgeReads.load(), BYTES);
+        ++failures;
+    }
+
+    loop->Schedule([&level, &edge]() {
+        level.DisableAll();
+        edge.DisableAll();
+    }).Wait();
+    return failures;
+}
+
+// two ready channels, the callback which runs first removes and destroys the other one.
+// @return: the number of failures.
+int CheckRemovalInBatch(const char *name, EventLoop *loop)
+{
+    Pipe pipes[2];
+    std::unique_ptr<EventChannel> channels[2];
+    std::atomic<int> calls{0};
+    loop->Schedule([loop, &pipes, &channels, &calls]() {
+        for (int i = 0; i < 2; ++i) {
+            channels[i] = std::make_unique<EventChannel>(pipes[i].ReadFd(), loop);
+            channels[i]->SetReadCallback([&channels, &calls, fd(pipes[i].ReadFd()), other(1 - i)](TimeStamp) {
+                char buf[BYTES] = {};
+                if (::read(fd, buf, BYTES) > 0) {
+                    ++calls;
+                }
+                if (channels[other] != nullptr) {
+                    channels[other]->DisableAll();
+                    channels[other].reset();
+                }
+            });
+            channels[i]->EnableReading();
+        }
+    }).Wait();
+    // both are reported by the same poll, the loop sleeps until the second write is done.
+    loop->Schedule([&pipes]() {
+        if (!pipes[0].Fill() || !pipes[1].Fill()) {
+            std::abort();
+        }
+    }).Wait();
+    bool passed = WaitFor(calls, 1);
+    if (!passed) {
+        std::printf("  %s: %d callbacks, the removed channel was dispatched\n", name, calls.load());
+    }
+
+    loop->Schedule([&channels]() {
+        for (auto &channel : channels) {
+            if (channel != nullptr) {
+                channel->DisableAll();
+                channel.reset();
+            }
+        }
+    }).Wait();
+    return passed ? 0 : 1;
+}
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    {
+        EventLoopOptions options;
+        options.pollerBackend = PollerBackend::EPOLL;
+        EventLoopThread loopThread("PollerTest", options);
+        EventLoop *loop = loopThread.Start();
+        failures += CheckBackend("epoll", loop);
+        failures += CheckRemovalInBatch("epoll", loop);
+    }
+
+    bool uringSupported = false;
+    {
+        EventLoopOptions options;
+        options.pollerBackend = PollerBackend::IO_URING;
+        EventLoopThread loopThread("PollerTest", options);
+        EventLoop *loop = loopThread.Start();
+        uringSupported = loop->Schedule([loop]() { return IoUringPoller::TryCreate(loop) != nullptr; }).Get();
+        if (uringSupported) {
+            failures += CheckBackend("io_uring", loop);
+            failures += CheckRemovalInBatch("io_uring", loop);
+        }
+    }
+
+    std::printf("poller_test: %d failures%s\n", failures, uringSupported ? "" : ", io_uring not supported");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of arming timers from threads other than the loop's: RunAfter, which assigns the
+// TimerId in the caller and posts the insertion, against the round trip through Schedule().Get()
+// which AddTimer used to do.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "event_loop_thread.h"
+
+using namespace FT;
+
+namespace {
+constexpr int ARMS_PER_THREAD = 20000;
+constexpr int THREAD_COUNTS[] = {1, 2, 4};
+// far enough to never fire while the benchmark runs.
+constexpr TimeType DELAY = TimeType(3600) * MICRO_SECS_PER_SECOND;
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Arm>
+std::vector<int64_t> Measure(int threadNum, Arm arm)
+{
+    std::vector<std::vector<int64_t>> samples(threadNum);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadNum; ++t) {
+        threads.emplace_back([&samples, &arm, t]() {
+            samples[t].reserve(ARMS_PER_THREAD);
+            for (int i = 0; i < ARMS_PER_THREAD; ++i) {
+                auto start = Clock::now();
+                if (!arm()) {
+                    std::abort();
+                }
+                auto elapsed = Clock::now() - start;
+                samples[t].emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int64_t> all;
+    for (auto &part : samples) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void Report(const char *name, int threadNum, const std::vector<int64_t> &samples)
+{
+    auto at = [&samples](double ratio) { return samples[static_cast<std::size_t>(ratio * (samples.size() - 1))]; };
+    std::printf("%22s %8d %10ld %10ld %10ld %12ld\n", name, threadNum, at(0.5), at(0.99), at(0.999), samples.back());
+}
+} // namespace
+
+int main()
+{
+    std::printf("timer_arm_benchmark: %d timers per thread, latency of one arm in ns\n", ARMS_PER_THREAD);
+    std::printf("%22s %8s %10s %10s %10s %12s\n", "path", "threads", "p50", "p99", "p99.9", "max");
+    for (int threadNum : THREAD_COUNTS) {
+        // a new loop for every run, so the timers armed by the earlier runs don't pile up.
+        {
+            EventLoopThread loopThread("ArmBench");
+            EventLoop *loop = loopThread.Start();
+            Report("RunAfter", threadNum, Measure(threadNum, [loop]() {
+                return loop->RunAfter([]() {}, DELAY) != nullptr;
+            }));
+        }
+        {
+            EventLoopThread loopThread("ArmBench");
+            EventLoop *loop = loopThread.Start();
+            Report("Schedule().Get() trip", threadNum, Measure(threadNum, [loop]() {
+                return loop->Schedule([loop]() { return loop->RunAfter([]() {}, DELAY); }).Get() != nullptr;
+            }));
+        }
+    }
+    return EXIT_SUCCESS;
+}
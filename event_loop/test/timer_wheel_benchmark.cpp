@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmark of the timer storages: 100k live timers, a third of them repeating like RunEvery,
+// with frequent cancels, driven by simulated time the way TimerQueue drives them.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "timer_pool.h"
+#include "timer_storage.h"
+
+using namespace FT;
+
+namespace {
+constexpr std::size_t TIMER_NUM = 100000;
+constexpr int REPEAT_PERCENT = 30;
+constexpr int CANCELS_PER_STEP = 100;
+constexpr int STEPS = 5000;
+constexpr TimeType STEP_MICROS = MICRO_SECS_PER_MILLISECOND; // 5s of simulated time.
+constexpr TimeType MAX_ONE_SHOT_DELAY = 10 * MICRO_SECS_PER_SECOND;
+constexpr TimeType INTERVALS[] = {16 * MICRO_SECS_PER_MILLISECOND, 100 * MICRO_SECS_PER_MILLISECOND,
+    MICRO_SECS_PER_SECOND};
+
+struct Result {
+    double nsPerOp = 0;
+    uint64_t ops = 0;
+    uint64_t fired = 0;
+    uint64_t canceled = 0;
+};
+
+class StorageBench {
+public:
+    explicit StorageBench(TimerQueueBackend backend)
+        : storage_(TimerStorage::Create(backend)), rng_(1), now_(TimeStamp::Now()), timers_(TIMER_NUM)
+    {
+        for (std::size_t slot = 0; slot < TIMER_NUM; ++slot) {
+            Add(slot, rng_() % 100 < REPEAT_PERCENT);
+        }
+        expired_.reserve(TIMER_NUM);
+    }
+
+    Result Run()
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < STEPS; ++step) {
+            now_ = TimeAdd(now_, STEP_MICROS);
+            expired_.clear();
+            storage_->TakeExpired(now_, expired_);
+            for (Timer *timer : expired_) {
+                ++result_.fired;
+                timer->Execute();
+                if (timer->IsRepeat()) {
+                    timer->Restart(timer->ExpireTime());
+                    storage_->Insert(timer);
+                    ++result_.ops;
+                } else {
+                    pool_.Recycle(timer);
+                }
+            }
+            for (int i = 0; i < CANCELS_PER_STEP; ++i) {
+                std::size_t slot = rng_() % TIMER_NUM;
+                Timer *timer = timers_[slot];
+                bool repeat = timer->IsRepeat();
+                storage_->Remove(timer);
+                pool_.Recycle(timer);
+                ++result_.canceled;
+                ++result_.ops;
+                Add(slot, repeat);
+            }
+            // TimerQueue asks for it to rearm the timerFd.
+            if (storage_->NextExpireTime() == TimeStamp::Invalid()) {
+                std::abort();
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        result_.ops += result_.fired;
+        result_.nsPerOp = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+            static_cast<double>(result_.ops);
+        return result_;
+    }
+
+private:
+    // a one-shot timer fired puts a new one in its slot, so the count of live timers stays the same.
+    void Add(std::size_t slot, bool repeat)
+    {
+        TimeType interval = repeat ? INTERVALS[rng_() % (sizeof(INTERVALS) / sizeof(INTERVALS[0]))] : 0;
+        TimeType delay = repeat ? interval : static_cast<TimeType>(rng_() % MAX_ONE_SHOT_DELAY) + 1;
+        Timer *timer = pool_.Acquire([this, slot]() {
+            if (!timers_[slot]->IsRepeat()) {
+                Add(slot, false);
+            }
+        }, TimeAdd(now_, delay), interval);
+        timer->SetState(TimerState::SCHEDULED);
+        timers_[slot] = timer;
+        storage_->Insert(timer);
+        ++result_.ops;
+    }
+
+    std::unique_ptr<TimerStorage> storage_;
+    std::mt19937_64 rng_;
+    TimeStamp now_;
+    TimerPool pool_;
+    std::vector<Timer *> timers_;
+    std::vector<Timer *> expired_;
+    Result result_;
+};
+
+void Report(const char *name, const Result &result)
+{
+    std::printf("%14s %10.1f %12lu %10lu %10lu\n", name, result.nsPerOp, result.ops, result.fired, result.canceled);
+}
+} // namespace
+
+int main()
+{
+    std::printf("timer_wheel_benchmark: %zu timers, %d%% repeating, %d cancels per %ldms step, %d steps\n",
+        TIMER_NUM, REPEAT_PERCENT, CANCELS_PER_STEP, STEP_MICROS / MICRO_SECS_PER_MILLISECOND, STEPS);
+    std::printf("%14s %10s %12s %10s %10s\n", "backend", "ns/op", "ops", "fired", "canceled");
+    Report("ordered set", StorageBench(TimerQueueBackend::ORDERED_SET).Run());
+    Report("timing wheel", StorageBench(TimerQueueBackend::TIMING_WHEEL).Run());
+    return EXIT_SUCCESS;
+}
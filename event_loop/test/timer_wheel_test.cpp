@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks TimerWheel against a brute force list of the live timers, driven the way TimerQueue drives
+// it: the time jumps to NextExpireTime() like the timerfd, or moves by a random step.
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "timer_pool.h"
+#include "timer_wheel.h"
+
+using namespace FT;
+
+namespace {
+constexpr TimeType TICK_MICROS = TimerWheel::DEFAULT_TICK_MICROS;
+constexpr int ROUNDS = 10;
+constexpr int STEPS_PER_ROUND = 50000;
+
+// delays spread over all the levels of the wheel, up to ~5.5 hours.
+TimeType RandomDelay(std::mt19937_64 &rng)
+{
+    constexpr TimeType level0Span = 256 * TICK_MICROS;
+    constexpr TimeType level1Span = level0Span * 64;
+    constexpr TimeType level2Span = level1Span * 64;
+    constexpr TimeType level3Span = level2Span * 64;
+    switch (rng() % 4) {
+        case 0:
+            return static_cast<TimeType>(rng() % level0Span);
+        case 1:
+            return static_cast<TimeType>(rng() % level1Span);
+        case 2:
+            return static_cast<TimeType>(rng() % level2Span);
+        default:
+            return static_cast<TimeType>(rng() % level3Span);
+    }
+}
+
+class WheelChecker {
+public:
+    explicit WheelChecker(uint64_t seed) : rng_(seed), now_(TimeStamp::Now()), wheel_(now_) {}
+
+    // @return: the number of failures.
+    int Run()
+    {
+        for (int step = 0; step < STEPS_PER_ROUND && failures_ == 0; ++step) {
+            int op = static_cast<int>(rng_() % 10);
+            if (op < 4) {
+                AddTimer();
+            } else if (op < 5) {
+                CancelTimer();
+            } else {
+                Advance();
+            }
+        }
+        return failures_;
+    }
+
+private:
+    void Fail(const char *what, TimeStamp expected, TimeStamp actual)
+    {
+        std::printf("  %s: expected %" PRId64 ", got %" PRId64 " (%" PRId64 " us off), now %" PRId64 "\n", what,
+            expected.Get(), actual.Get(), TimeDiff(actual, expected), now_.Get());
+        ++failures_;
+    }
+
+    void AddTimer()
+    {
+        Timer *timer = pool_.Acquire(nullptr, TimeAdd(now_, RandomDelay(rng_)));
+        timer->SetState(TimerState::SCHEDULED);
+        wheel_.Insert(timer);
+        live_.emplace_back(timer);
+    }
+
+    void CancelTimer()
+    {
+        if (live_.empty()) {
+            return;
+        }
+        std::size_t index = rng_() % live_.size();
+        Timer *timer = live_[index];
+        live_[index] = live_.back();
+        live_.pop_back();
+        wheel_.Remove(timer);
+        pool_.Recycle(timer);
+    }
+
+    void Advance()
+    {
+        TimeStamp next = wheel_.NextExpireTime();
+        if (live_.empty()) {
+            if (next != TimeStamp::Invalid()) {
+                Fail("next expire time of an empty wheel", TimeStamp::Invalid(), next);
+            }
+            now_ = TimeAdd(now_, static_cast<TimeType>(rng_() % (16 * TICK_MICROS)));
+            return;
+        }
+
+        // the wheel may ask to be checked early, never after the earliest timer's tick.
+        TimeStamp earliest = (*std::min_element(live_.begin(), live_.end(), [](Timer *lhs, Timer *rhs) {
+            return lhs->ExpireTime() < rhs->ExpireTime();
+        }))->ExpireTime();
+        if (next == TimeStamp::Invalid() || next > TimeAdd(earliest, TICK_MICROS)) {
+            Fail("next expire time", earliest, next);
+            return;
+        }
+
+        if (rng_() % 2 == 0) {
+            now_ = std::max(now_, next);
+        } else {
+            now_ = TimeAdd(now_, static_cast<TimeType>(rng_() % (16 * TICK_MICROS)));
+        }
+        TakeExpired();
+    }
+
+    void TakeExpired()
+    {
+        expired_.clear();
+        wheel_.TakeExpired(now_, expired_);
+        for (Timer *timer : expired_) {
+            if (timer->ExpireTime() > now_) {
+                Fail("timer fired early", timer->ExpireTime(), now_);
+            }
+            auto iter = std::find(live_.begin(), live_.end(), timer);
+            if (iter == live_.end()) {
+                Fail("unknown timer fired", TimeStamp::Invalid(), timer->ExpireTime());
+                continue;
+            }
+            *iter = live_.back();
+            live_.pop_back();
+            pool_.Recycle(timer);
+        }
+
+        for (Timer *timer : live_) {
+            if (TimeAdd(timer->ExpireTime(), TICK_MICROS) <= now_) {
+                Fail("timer not fired", timer->ExpireTime(), now_);
+            }
+        }
+        if (wheel_.Size() != live_.size()) {
+            std::printf("  size: expected %zu, got %zu\n", live_.size(), wheel_.Size());
+            ++failures_;
+        }
+    }
+
+    std::mt19937_64 rng_;
+    TimeStamp now_;
+    TimerWheel wheel_;
+    TimerPool pool_;
+    std::vector<Timer *> live_;
+    std::vector<Timer *> expired_;
+    int failures_ = 0;
+};
+} // namespace
+
+int main()
+{
+    int failedRounds = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        uint64_t seed = static_cast<uint64_t>(round) + 1;
+        if (WheelChecker(seed).Run() != 0) {
+            std::printf("round %d (seed %" PRIu64 ") failed\n", round, seed);
+            ++failedRounds;
+        }
+    }
+
+    std::printf("timer_wheel_test: %d of %d rounds failed\n", failedRounds, ROUNDS);
+    return failedRounds == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
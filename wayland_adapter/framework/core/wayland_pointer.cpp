@@ -59,7 +59,7 @@ WaylandPointer::~WaylandPointer() noexcept
     LOG_DEBUG("WaylandPointer release, this=%{public}p", this);
 }
 
-void WaylandPointer::OnPointerButton(uint32_t time, uint32_t button, bool isPressed)
+void WaylandPointer::OnPointerButton(uint32_t time, uint32_t button, bool isPressed, bool sendFrame)
 {
     wl_resource *pointer = WlResource();
     if (pointer == nullptr) {
@@ -72,10 +72,12 @@ void WaylandPointer::OnPointerButton(uint32_t time, uint32_t button, bool isPres
     uint32_t serial = wl_display_next_serial(display);
     uint32_t state = isPressed ? WL_POINTER_BUTTON_STATE_PRESSED : WL_POINTER_BUTTON_STATE_RELEASED;
     wl_pointer_send_button(pointer, serial, time, button, state);
-    wl_pointer_send_frame(pointer);
+    if (sendFrame) {
+        wl_pointer_send_frame(pointer);
+    }
 }
 
-void WaylandPointer::OnPointerMotionAbsolute(uint32_t time, int32_t posX, int32_t posY)
+void WaylandPointer::OnPointerMotionAbsolute(uint32_t time, int32_t posX, int32_t posY, bool sendFrame)
 {
     wl_fixed_t posFixedX = wl_fixed_from_int(posX);
     wl_fixed_t posFixedY = wl_fixed_from_int(posY);
@@ -85,10 +87,12 @@ void WaylandPointer::OnPointerMotionAbsolute(uint32_t time, int32_t posX, int32_
     }
 
     wl_pointer_send_motion(pointer, time, posFixedX, posFixedY);
-    wl_pointer_send_frame(pointer);
+    if (sendFrame) {
+        wl_pointer_send_frame(pointer);
+    }
 }
 
-void WaylandPointer::OnPointerLeave(struct wl_resource *surface_resource)
+void WaylandPointer::OnPointerLeave(struct wl_resource *surface_resource, bool sendFrame)
 {
     wl_display *display = WlDisplay();
     if (display == nullptr) {
@@ -100,10 +104,12 @@ void WaylandPointer::OnPointerLeave(struct wl_resource *surface_resource)
         return;
     }
     wl_pointer_send_leave(pointer, serial, surface_resource);
-    wl_pointer_send_frame(pointer);
+    if (sendFrame) {
+        wl_pointer_send_frame(pointer);
+    }
 }
 
-void WaylandPointer::OnPointerEnter(int32_t posX, int32_t posY, struct wl_resource *surface_resource)
+void WaylandPointer::OnPointerEnter(int32_t posX, int32_t posY, struct wl_resource *surface_resource, bool sendFrame)
 {
     wl_fixed_t posFixedX = wl_fixed_from_int(posX);
     wl_fixed_t posFixedY = wl_fixed_from_int(posY);
@@ -117,6 +123,17 @@ void WaylandPointer::OnPointerEnter(int32_t posX, int32_t posY, struct wl_resour
     }
     uint32_t serial = wl_display_next_serial(display);
     wl_pointer_send_enter(pointer, serial, surface_resource, posFixedX, posFixedY);
+    if (sendFrame) {
+        wl_pointer_send_frame(pointer);
+    }
+}
+
+void WaylandPointer::OnPointerFrame()
+{
+    wl_resource *pointer = WlResource();
+    if (pointer == nullptr) {
+        return;
+    }
     wl_pointer_send_frame(pointer);
 }
 
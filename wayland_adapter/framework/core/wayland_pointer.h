@@ -33,10 +33,13 @@ public:
     static OHOS::sptr<WaylandPointer> Create(struct wl_client *client, uint32_t version, uint32_t id);
     ~WaylandPointer() noexcept override;
 
-    void OnPointerLeave(struct wl_resource *surface_resource);
-    void OnPointerEnter(int32_t posX, int32_t posY, struct wl_resource *surface_resource);
-    void OnPointerButton(uint32_t time, uint32_t button, bool isPressed);
-    void OnPointerMotionAbsolute(uint32_t time, int32_t posX, int32_t posY);
+    // @sendFrame: end the event with a wl_pointer.frame, false to group it with the following
+    // events until OnPointerFrame.
+    void OnPointerLeave(struct wl_resource *surface_resource, bool sendFrame = true);
+    void OnPointerEnter(int32_t posX, int32_t posY, struct wl_resource *surface_resource, bool sendFrame = true);
+    void OnPointerButton(uint32_t time, uint32_t button, bool isPressed, bool sendFrame = true);
+    void OnPointerMotionAbsolute(uint32_t time, int32_t posX, int32_t posY, bool sendFrame = true);
+    void OnPointerFrame();
     bool IsCursorSurface(struct wl_resource *surface);
 
 private:
@@ -31,6 +31,14 @@ namespace {
 static OHOS::sptr<WaylandSeat> wl_seat_global = nullptr;
 std::mutex wl_seat_global_mutex_;
 
+static void InvalidateSeatInputTargets(struct wl_client *client)
+{
+    OHOS::sptr<WaylandSeat> wlSeat = WaylandSeat::GetWaylandSeatGlobal();
+    if (wlSeat != nullptr) {
+        wlSeat->InvalidateInputTargets(client);
+    }
+}
+
 struct wl_seat_interface IWaylandSeat::impl_ = {
     .get_pointer = GetPointer,
     .get_keyboard = GetKeyboard,
@@ -83,6 +91,7 @@ OHOS::sptr<WaylandSeat> WaylandSeat::GetWaylandSeatGlobal()
 
 void WaylandSeat::FreeSeatResource(struct wl_client *client, struct wl_resource *resource)
 {
+    InvalidateInputTargets(client);
     std::lock_guard<std::mutex> lock(seatResourcesMutex_);
     auto iter = seatResourcesMap_.find(client);
     if (iter == seatResourcesMap_.end()) {
@@ -120,58 +129,41 @@ void WaylandSeat::Bind(struct wl_client *client, uint32_t version, uint32_t id)
         return;
     }
 
+    InvalidateInputTargets(client);
     std::lock_guard<std::mutex> lock(seatResourcesMutex_);
     WaylandObjectsPool::GetInstance().AddObject(ObjectId(object->WlClient(), object->Id()), object);
     seatResourcesMap_[client].emplace_back(object);
     UpdateCapabilities(object->WlResource());
 }
 
-void WaylandSeat::GetKeyboardResource(struct wl_client *client, std::list<OHOS::sptr<WaylandKeyboard>>& list)
+const SeatInputTargets &WaylandSeat::GetInputTargets(struct wl_client *client)
 {
+    auto cached = inputTargets_.find(client);
+    if (cached != inputTargets_.end()) {
+        return cached->second;
+    }
+
+    static const SeatInputTargets emptyTargets;
     std::lock_guard<std::mutex> lock(seatResourcesMutex_);
     auto iter = seatResourcesMap_.find(client);
     if (iter == seatResourcesMap_.end()) {
-        return;
+        // not cached, it would never be invalidated if the client does not bind a seat.
+        return emptyTargets;
     }
 
-    /* A wl_client object maybe has many seatResourceObjects, each seatResourceObject maybe has many keyboardResourceObjects
-     * so we need get all keyboardResourceObjects in this wl_client object.
+    /* A wl_client object maybe has many seatResourceObjects, each seatResourceObject maybe has many
+     * pointerResourceObjects and keyboardResourceObjects, so we need get all of them in this wl_client object.
      */
-    auto seatList = iter->second;
-    for (auto& seatResourceItem : seatList) {
-        std::list<OHOS::sptr<WaylandKeyboard>> KeyboardList;
-        seatResourceItem->GetChildKeyboard(KeyboardList);
-        if (KeyboardList.empty()) {
-            continue;
-        }
-        for (auto& keyboardResourceItem : KeyboardList) {
-            list.emplace_back(keyboardResourceItem);
-        }
+    auto &targets = inputTargets_[client];
+    for (auto &seatResourceItem : iter->second) {
+        seatResourceItem->CollectInputTargets(targets);
     }
+    return targets;
 }
 
-void WaylandSeat::GetPointerResource(struct wl_client *client, std::list<OHOS::sptr<WaylandPointer>>& list)
+void WaylandSeat::InvalidateInputTargets(struct wl_client *client)
 {
-    std::lock_guard<std::mutex> lock(seatResourcesMutex_);
-    auto iter = seatResourcesMap_.find(client);
-    if (iter == seatResourcesMap_.end()) {
-        return;
-    }
-
-    /* A wl_client object maybe has many seatResourceObjects, each seatResourceObject maybe has many pointerResourceObjects
-     * so we need get all pointerResourceObjects in this wl_client object.
-     */
-    auto seatList = iter->second;
-    for (auto& seatResourceItem : seatList) {
-        std::list<OHOS::sptr<WaylandPointer>> pointerList;
-        seatResourceItem->GetChildPointer(pointerList);
-        if (pointerList.empty()) {
-            continue;
-        }
-        for (auto& pointerResourceItem : pointerList) {
-            list.emplace_back(pointerResourceItem);
-        }
-    }
+    inputTargets_.erase(client);
 }
 
 bool WaylandSeat::IsHotPlugIn()
@@ -337,6 +329,23 @@ void WaylandSeatObject::GetChildKeyboard(std::list<OHOS::sptr<WaylandKeyboard>>
     list = iter->second;
 }
 
+void WaylandSeatObject::CollectInputTargets(SeatInputTargets &targets) const
+{
+    auto pointerIter = pointerResourcesMap_.find(WlClient());
+    if (pointerIter != pointerResourcesMap_.end()) {
+        for (auto &pointer : pointerIter->second) {
+            targets.pointers.emplace_back(pointer.GetRefPtr());
+        }
+    }
+
+    auto keyboardIter = keyboardResourcesMap_.find(WlClient());
+    if (keyboardIter != keyboardResourcesMap_.end()) {
+        for (auto &keyboard : keyboardIter->second) {
+            targets.keyboards.emplace_back(keyboard.GetRefPtr());
+        }
+    }
+}
+
 void WaylandSeatObject::GetPointer(uint32_t id)
 {
     auto pointer = WaylandPointer::Create(WlClient(), wl_resource_get_version(WlResource()), id);
@@ -346,6 +355,7 @@ void WaylandSeatObject::GetPointer(uint32_t id)
     }
 
     pointerResourcesMap_[WlClient()].emplace_back(pointer);
+    InvalidateSeatInputTargets(WlClient());
 }
 
 void WaylandSeatObject::GetKeyboard(uint32_t id)
@@ -356,6 +366,7 @@ void WaylandSeatObject::GetKeyboard(uint32_t id)
         return;
     }
     keyboardResourcesMap_[WlClient()].emplace_back(keyboard);
+    InvalidateSeatInputTargets(WlClient());
 }
 
 void WaylandSeatObject::GetTouch(uint32_t id)
@@ -16,6 +16,8 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "input_manager.h"
 #include "wayland_global.h"
 #include "wayland_pointer.h"
@@ -33,14 +35,23 @@ struct IWaylandSeat {
 
 class WaylandSeatObject;
 
+// the pointers and keyboards of all the seats bound by one client.
+struct SeatInputTargets {
+    std::vector<WaylandPointer *> pointers;
+    std::vector<WaylandKeyboard *> keyboards;
+};
+
 class WaylandSeat final : public WaylandGlobal {
     friend struct IWaylandSeat;
 
 public:
     static OHOS::sptr<WaylandSeat> Create(struct wl_display *display);
     static OHOS::sptr<WaylandSeat> GetWaylandSeatGlobal();
-    void GetPointerResource(struct wl_client *client, std::list<OHOS::sptr<WaylandPointer>> &list);
-    void GetKeyboardResource(struct wl_client *client, std::list<OHOS::sptr<WaylandKeyboard>> &list);
+    // display loop only, without locking or allocating unless the client's seats changed. The targets stay
+    // valid until the next request of the client is dispatched, the seat objects keep them alive.
+    const SeatInputTargets &GetInputTargets(struct wl_client *client);
+    // display loop only, called when a seat, pointer or keyboard of @client is created or destroyed.
+    void InvalidateInputTargets(struct wl_client *client);
     bool IsHotPlugIn();
     void ResetHotPlugIn();
     ~WaylandSeat() noexcept override;
@@ -77,6 +88,8 @@ private:
     std::shared_ptr<WaylandInputDeviceListener> inputListener_;
     std::unordered_map<struct wl_client *, std::list<OHOS::sptr<WaylandSeatObject>>> seatResourcesMap_;
     mutable std::mutex seatResourcesMutex_;
+    // rebuilt from seatResourcesMap_ on the first input event after a change, touched by the display loop only.
+    std::unordered_map<struct wl_client *, SeatInputTargets> inputTargets_;
     mutable std::mutex capsMutex_;
     uint32_t caps_ = 0;
     bool isHotPlugIn_ = false;
@@ -90,6 +103,7 @@ public:
     ~WaylandSeatObject() noexcept;
     void GetChildPointer(std::list<OHOS::sptr<WaylandPointer>> &list);
     void GetChildKeyboard(std::list<OHOS::sptr<WaylandKeyboard>> &list);
+    void CollectInputTargets(SeatInputTargets &targets) const;
     void OnResourceDestroy() override;
 
 private:
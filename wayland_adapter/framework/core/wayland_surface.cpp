@@ -13,7 +13,9 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <linux/input.h>
+#include <utility>
 #include "wayland_surface.h"
 
 #include "wayland_objects_pool.h"
@@ -28,6 +30,33 @@ namespace Wayland {
 namespace {
     constexpr HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WAYLAND, "WaylandSurface"};
     constexpr uint32_t US_TO_MS = 1000;
+    std::atomic<uint64_t> g_motionReceived{0};
+    std::atomic<uint64_t> g_motionSent{0};
+    // the sent motions by how many received ones each of them stands for: 1, 2, 3-4, 5-8 and more.
+    constexpr std::size_t MOTION_MERGE_BUCKETS = 5;
+    std::atomic<uint64_t> g_motionMerges[MOTION_MERGE_BUCKETS] = {};
+    std::atomic<uint64_t> g_motionMergeMax{0};
+    std::atomic<uint64_t> g_pointerFrames{0};
+    std::atomic<uint64_t> g_pointerFramesSkipped{0}; // nothing was sent to the pointers.
+
+    // the counters are only written by the display loop.
+    void Bump(std::atomic<uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void RecordMotionSent(uint32_t merged)
+    {
+        Bump(g_motionSent);
+        std::size_t bucket = 0;
+        for (uint32_t limit = 1; bucket + 1 < MOTION_MERGE_BUCKETS && merged > limit; limit *= 2) {
+            ++bucket;
+        }
+        Bump(g_motionMerges[bucket]);
+        if (merged > g_motionMergeMax.load(std::memory_order_relaxed)) {
+            g_motionMergeMax.store(merged, std::memory_order_relaxed);
+        }
+    }
 }
 
 #ifdef ENABLE_GPU
@@ -49,6 +78,22 @@ private:
     OHOS::wptr<WaylandSurface> wlSurface_ = nullptr;
     int32_t MapPointerActionButton(int32_t PointerActionButtonType) const;
     int32_t MapKeyAction(int32_t keyAction) const;
+    void FlushPendingMotion(uint64_t epoch) const;
+    // send @motion then @pointerEvent, either may be null, to the pointers of the surface in one frame.
+    // @mergedMotions: how many received motions @motion stands for.
+    void SendPointerEvents(const std::shared_ptr<OHOS::MMI::PointerEvent> &motion, uint32_t mergedMotions,
+        const std::shared_ptr<OHOS::MMI::PointerEvent> &pointerEvent) const;
+    // @return: whether any event was sent to the pointers.
+    bool SendPointerEvent(const std::shared_ptr<OHOS::MMI::PointerEvent> &pointerEvent,
+        const OHOS::sptr<WaylandSeat> &wlSeat, const OHOS::sptr<WaylandSurface> &wlSurface,
+        const SeatInputTargets &targets) const;
+
+    // consecutive motions are merged into one per iteration of the display loop: the latest one waits here
+    // until the flush queued by the first one runs, or until a button, enter, leave or key event sends it.
+    mutable std::mutex motionMutex_;
+    mutable std::shared_ptr<OHOS::MMI::PointerEvent> pendingMotion_;
+    mutable uint32_t pendingMotionMerged_ = 0; // the received motions pendingMotion_ stands for.
+    mutable uint64_t motionEpoch_ = 0; // tells the flushes queued before a button, enter or leave to skip.
     const std::map<uint32_t, int32_t> ptrActionMap_ = {
         {OHOS::MMI::PointerEvent::MOUSE_BUTTON_LEFT,   BTN_LEFT},
         {OHOS::MMI::PointerEvent::MOUSE_BUTTON_RIGHT,  BTN_RIGHT},
@@ -81,7 +126,15 @@ int32_t InputEventConsumer::MapPointerActionButton(int32_t PointerActionButtonTy
 bool InputEventConsumer::OnInputEvent(const std::shared_ptr<OHOS::MMI::KeyEvent>& keyEvent) const
 {
     keyEvent->MarkProcessed();
-    WaylandEventLoop::GetInstance().QueueToLoop([this, keyEvent]{
+    // the unsent pointer motion happened before this key.
+    std::lock_guard<std::mutex> lock(motionMutex_);
+    auto motion = std::move(pendingMotion_);
+    pendingMotion_ = nullptr;
+    uint32_t merged = std::exchange(pendingMotionMerged_, 0);
+    WaylandEventLoop::GetInstance().QueueToLoop([this, keyEvent, motion, merged]{
+        if (motion != nullptr) {
+            SendPointerEvents(motion, merged, nullptr);
+        }
         OHOS::sptr<WaylandSeat> wlSeat = WaylandSeat::GetWaylandSeatGlobal();
         if (wlSeat == nullptr) {
             return;
@@ -90,18 +143,16 @@ bool InputEventConsumer::OnInputEvent(const std::shared_ptr<OHOS::MMI::KeyEvent>
         if (wlSurface == nullptr) {
             return;
         }
-        std::list<OHOS::sptr<WaylandKeyboard>> keyboardList;
-        wlSeat->GetKeyboardResource(wlSurface->WlClient(), keyboardList);
         int32_t keyAction = MapKeyAction(keyEvent->GetKeyAction());
         if (keyAction == INVALID_KEYACTION) {
             return;
         }
 
-        for (auto &keyboard : keyboardList) {
+        for (auto keyboard : wlSeat->GetInputTargets(wlSurface->WlClient()).keyboards) {
             keyboard->OnKeyboardKey(keyEvent->GetKeyCode(), keyAction, keyEvent->GetActionTime() / US_TO_MS);
         }
-        wl_display_flush_clients(wlSurface->WlDisplay());
-    });
+        WaylandEventLoop::GetInstance().ScheduleFlush();
+    }, FunctorPriority::INPUT);
 
     return true;
 }
@@ -115,73 +166,163 @@ bool InputEventConsumer::OnInputEvent(const std::shared_ptr<OHOS::MMI::AxisEvent
 bool InputEventConsumer::OnInputEvent(const std::shared_ptr<OHOS::MMI::PointerEvent>& pointerEvent) const
 {
     pointerEvent->MarkProcessed();
-    WaylandEventLoop::GetInstance().QueueToLoop([this, pointerEvent]{
-        OHOS::sptr<WaylandSeat> wlSeat = WaylandSeat::GetWaylandSeatGlobal();
-        if (wlSeat == nullptr) {
-            return;
-        }
-        auto wlSurface = wlSurface_.promote();
-        if (wlSurface == nullptr) {
-            return;
+    std::lock_guard<std::mutex> lock(motionMutex_);
+    if (pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_MOVE) {
+        g_motionReceived.fetch_add(1, std::memory_order_relaxed);
+        bool flushQueued = pendingMotion_ != nullptr;
+        // only the latest position matters, the queued flush sends it.
+        pendingMotion_ = pointerEvent;
+        ++pendingMotionMerged_;
+        if (!flushQueued) {
+            uint64_t epoch = ++motionEpoch_;
+            WaylandEventLoop::GetInstance().QueueToLoop([this, epoch] { FlushPendingMotion(epoch); },
+                FunctorPriority::INPUT);
         }
-        std::list<OHOS::sptr<WaylandPointer>> pointerList;
-        std::list<OHOS::sptr<WaylandKeyboard>> keyboardList;
-        wlSeat->GetPointerResource(wlSurface->WlClient(), pointerList);
-        wlSeat->GetKeyboardResource(wlSurface->WlClient(), keyboardList);
-
-        OHOS::MMI::PointerEvent::PointerItem pointerItem;
-        int32_t pointId = pointerEvent->GetPointerId();
-        if (!pointerEvent->GetPointerItem(pointId, pointerItem)) {
-            LOG_WARN("GetPointerItem fail");
+        return true;
+    }
+
+    // the unsent motion goes first in the same frame, queued under the lock so no later motion overtakes it.
+    auto motion = std::move(pendingMotion_);
+    pendingMotion_ = nullptr;
+    uint32_t merged = std::exchange(pendingMotionMerged_, 0);
+    WaylandEventLoop::GetInstance().QueueToLoop([this, motion, merged, pointerEvent] {
+        SendPointerEvents(motion, merged, pointerEvent);
+    }, FunctorPriority::INPUT);
+    return true;
+}
+
+void InputEventConsumer::FlushPendingMotion(uint64_t epoch) const
+{
+    std::shared_ptr<OHOS::MMI::PointerEvent> motion;
+    uint32_t merged = 0;
+    {
+        std::lock_guard<std::mutex> lock(motionMutex_);
+        // a button, enter, leave or key event already sent it, and a later motion has its own flush.
+        if (epoch != motionEpoch_ || pendingMotion_ == nullptr) {
             return;
         }
+        motion = std::move(pendingMotion_);
+        pendingMotion_ = nullptr;
+        merged = std::exchange(pendingMotionMerged_, 0);
+    }
+    SendPointerEvents(motion, merged, nullptr);
+}
 
-        OHOS::Rosen::Rect rect = wlSurface->GetWindowGeometry();
-        if (rect.posX_ >= 0 && rect.posY_ >= 0 && rect.width_ > 0 && rect.height_ > 0) {
-            pointerItem.SetWindowX(pointerItem.GetWindowX() + rect.posX_);
-            pointerItem.SetWindowY(pointerItem.GetWindowY() + rect.posY_);
+void InputEventConsumer::SendPointerEvents(const std::shared_ptr<OHOS::MMI::PointerEvent> &motion,
+    uint32_t mergedMotions, const std::shared_ptr<OHOS::MMI::PointerEvent> &pointerEvent) const
+{
+    OHOS::sptr<WaylandSeat> wlSeat = WaylandSeat::GetWaylandSeatGlobal();
+    if (wlSeat == nullptr) {
+        return;
+    }
+    auto wlSurface = wlSurface_.promote();
+    if (wlSurface == nullptr) {
+        return;
+    }
+    const SeatInputTargets &targets = wlSeat->GetInputTargets(wlSurface->WlClient());
+    bool sent = false;
+    if (motion != nullptr && SendPointerEvent(motion, wlSeat, wlSurface, targets)) {
+        RecordMotionSent(mergedMotions);
+        sent = true;
+    }
+    if (pointerEvent != nullptr && SendPointerEvent(pointerEvent, wlSeat, wlSurface, targets)) {
+        sent = true;
+    }
+    // a frame without any event before it would be an empty one for the clients.
+    if (sent) {
+        for (auto pointer : targets.pointers) {
+            pointer->OnPointerFrame();
         }
+        Bump(g_pointerFrames);
+    } else {
+        Bump(g_pointerFramesSkipped);
+    }
+    // the keyboards may have got an enter or leave anyway.
+    WaylandEventLoop::GetInstance().ScheduleFlush();
+}
 
-        if (wlSeat->IsHotPlugIn()) {
-            for (auto &pointer : pointerList) {
-                pointer->OnPointerEnter(pointerItem.GetWindowX(), pointerItem.GetWindowY(), wlSurface->WlResource());
-            }
-            for (auto &keyboard : keyboardList) {
-                keyboard->OnKeyboardEnter(wlSurface->WlResource());
-            }
-            wlSeat->ResetHotPlugIn();
+bool InputEventConsumer::SendPointerEvent(const std::shared_ptr<OHOS::MMI::PointerEvent> &pointerEvent,
+    const OHOS::sptr<WaylandSeat> &wlSeat, const OHOS::sptr<WaylandSurface> &wlSurface,
+    const SeatInputTargets &targets) const
+{
+    OHOS::MMI::PointerEvent::PointerItem pointerItem;
+    int32_t pointId = pointerEvent->GetPointerId();
+    if (!pointerEvent->GetPointerItem(pointId, pointerItem)) {
+        LOG_WARN("GetPointerItem fail");
+        return false;
+    }
+
+    OHOS::Rosen::Rect rect = wlSurface->GetWindowGeometry();
+    if (rect.posX_ >= 0 && rect.posY_ >= 0 && rect.width_ > 0 && rect.height_ > 0) {
+        pointerItem.SetWindowX(pointerItem.GetWindowX() + rect.posX_);
+        pointerItem.SetWindowY(pointerItem.GetWindowY() + rect.posY_);
+    }
+
+    // every branch below sends one event to each pointer, if any.
+    bool sent = false;
+    if (wlSeat->IsHotPlugIn()) {
+        sent = !targets.pointers.empty();
+        for (auto pointer : targets.pointers) {
+            pointer->OnPointerEnter(pointerItem.GetWindowX(), pointerItem.GetWindowY(), wlSurface->WlResource(),
+                false);
+        }
+        for (auto keyboard : targets.keyboards) {
+            keyboard->OnKeyboardEnter(wlSurface->WlResource());
         }
+        wlSeat->ResetHotPlugIn();
+    }
 
-        if (pointerEvent->GetPointerAction() ==  OHOS::MMI::PointerEvent::POINTER_ACTION_ENTER_WINDOW) {
-            for (auto &pointer : pointerList) {
-                pointer->OnPointerEnter(pointerItem.GetWindowX(), pointerItem.GetWindowY(), wlSurface->WlResource());
-            }
-            for (auto &keyboard : keyboardList) {
-                keyboard->OnKeyboardEnter(wlSurface->WlResource());
-            }
-        } else if (pointerEvent->GetPointerAction() ==  OHOS::MMI::PointerEvent::POINTER_ACTION_LEAVE_WINDOW) {
-            for (auto &pointer : pointerList) {
-                pointer->OnPointerLeave(wlSurface->WlResource());
-            }
-            for (auto &keyboard : keyboardList) {
-                keyboard->OnKeyboardLeave(wlSurface->WlResource());
-            }
-        } else if (pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_BUTTON_DOWN ||
-            pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_BUTTON_UP) {
-            int32_t buttonId = MapPointerActionButton(pointerEvent->GetButtonId());
-            if (buttonId != OHOS::MMI::PointerEvent::BUTTON_NONE) {
-                for (auto &pointer : pointerList) {
-                    pointer->OnPointerButton(pointerEvent->GetActionTime() / US_TO_MS, buttonId, pointerItem.IsPressed());
-                }
-            }
-        } else if (pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_MOVE) {
-            for (auto &pointer : pointerList) {
-                pointer->OnPointerMotionAbsolute(pointerEvent->GetActionTime() / US_TO_MS, pointerItem.GetWindowX(), pointerItem.GetWindowY());
+    if (pointerEvent->GetPointerAction() ==  OHOS::MMI::PointerEvent::POINTER_ACTION_ENTER_WINDOW) {
+        sent = sent || !targets.pointers.empty();
+        for (auto pointer : targets.pointers) {
+            pointer->OnPointerEnter(pointerItem.GetWindowX(), pointerItem.GetWindowY(), wlSurface->WlResource(),
+                false);
+        }
+        for (auto keyboard : targets.keyboards) {
+            keyboard->OnKeyboardEnter(wlSurface->WlResource());
+        }
+    } else if (pointerEvent->GetPointerAction() ==  OHOS::MMI::PointerEvent::POINTER_ACTION_LEAVE_WINDOW) {
+        sent = sent || !targets.pointers.empty();
+        for (auto pointer : targets.pointers) {
+            pointer->OnPointerLeave(wlSurface->WlResource(), false);
+        }
+        for (auto keyboard : targets.keyboards) {
+            keyboard->OnKeyboardLeave(wlSurface->WlResource());
+        }
+    } else if (pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_BUTTON_DOWN ||
+        pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_BUTTON_UP) {
+        int32_t buttonId = MapPointerActionButton(pointerEvent->GetButtonId());
+        if (buttonId != OHOS::MMI::PointerEvent::BUTTON_NONE) {
+            sent = sent || !targets.pointers.empty();
+            for (auto pointer : targets.pointers) {
+                pointer->OnPointerButton(pointerEvent->GetActionTime() / US_TO_MS, buttonId, pointerItem.IsPressed(),
+                    false);
             }
         }
-        wl_display_flush_clients(wlSurface->WlDisplay());
-    });
-    return true;
+    } else if (pointerEvent->GetPointerAction() == OHOS::MMI::PointerEvent::POINTER_ACTION_MOVE) {
+        sent = sent || !targets.pointers.empty();
+        for (auto pointer : targets.pointers) {
+            pointer->OnPointerMotionAbsolute(pointerEvent->GetActionTime() / US_TO_MS, pointerItem.GetWindowX(),
+                pointerItem.GetWindowY(), false);
+        }
+    }
+    return sent;
+}
+
+void WaylandSurface::DumpInputStats(std::string &out)
+{
+    uint64_t received = g_motionReceived.load(std::memory_order_relaxed);
+    uint64_t sent = g_motionSent.load(std::memory_order_relaxed);
+    AppendFormat(out, "Pointer motion: %lu received, %lu sent, coalescing ratio %.2f\n", received, sent,
+        sent == 0 ? 0.0 : static_cast<double>(received) / static_cast<double>(sent));
+    uint64_t merges[MOTION_MERGE_BUCKETS];
+    for (std::size_t i = 0; i < MOTION_MERGE_BUCKETS; ++i) {
+        merges[i] = g_motionMerges[i].load(std::memory_order_relaxed);
+    }
+    AppendFormat(out, "  received motions per sent one: 1: %lu, 2: %lu, 3-4: %lu, 5-8: %lu, 9+: %lu, max: %lu\n",
+        merges[0], merges[1], merges[2], merges[3], merges[4], g_motionMergeMax.load(std::memory_order_relaxed));
+    AppendFormat(out, "Pointer frames: %lu sent, %lu skipped with no pointer event\n",
+        g_pointerFrames.load(std::memory_order_relaxed), g_pointerFramesSkipped.load(std::memory_order_relaxed));
 }
 
 
@@ -435,13 +576,8 @@ void WaylandSurface::Offset(int32_t x, int32_t y)
 }
 
 void WaylandSurface::HandleCommit() {
-    int32_t timeMs = 0;
-    struct timespec ts = { 0, 0 };
-    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
-        timeMs = (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
-    } else {
-        LOG_ERROR("Failed to clock_gettime");
-    }
+    // the commits handled in one iteration of the display loop share its clock.
+    uint32_t timeMs = WaylandEventLoop::GetInstance().NowMillis();
 
     if (new_.buffer != nullptr) {
         wl_shm_buffer *shm = wl_shm_buffer_get(new_.buffer);
@@ -481,9 +617,7 @@ void WaylandSurface::CheckIsPointerSurface()
         return;
     }
 
-    std::list<OHOS::sptr<WaylandPointer>> pointerList;
-    wlSeat->GetPointerResource(WlClient(), pointerList);
-    for (auto &pointer : pointerList) {
+    for (auto pointer : wlSeat->GetInputTargets(WlClient()).pointers) {
         isPointerSurface_ = pointer->IsCursorSurface(WlResource());
         if (isPointerSurface_) {
             break;
@@ -71,6 +71,8 @@ public:
     void AddParent(struct wl_resource *parent);
     void ProcessSrcBitmap(SkCanvas* canvas, int32_t x, int32_t y);
     void TriggerInnerCompose();
+    // append the pointer motion coalescing counters of all the surfaces to @out, for the SA dump.
+    static void DumpInputStats(std::string &out);
     void IsSubSurface(bool isSubSurface)
     {
         isSubSurface_ = isSubSurface;
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Microbenchmark of WaylandObjectsPool with 10k objects across 100 clients: the old pool, one std::map
+// keyed by (client, id) behind a mutex taken for every call, against the per-client tables which the
+// display loop reads without locking now. Both are modelled here with the same containers and lookups,
+// the real pool holds WaylandResourceObjects which need a display and bound clients.
+// Measures adding the objects, looking them up in the display loop and from another thread (which
+// still locks), and removing them.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "refbase.h"
+
+namespace {
+constexpr int CLIENTS = 100;
+constexpr int OBJECTS_PER_CLIENT = 100;
+constexpr int SERVER_OBJECTS_PER_CLIENT = 4; // wl_data_offer and the like, created by the server.
+constexpr int LOOKUPS = 2000000;
+constexpr uint32_t SERVER_ID_START = 0xff000000;
+constexpr uint32_t MAX_DENSE_ID_GAP = 1024;
+
+using Clock = std::chrono::steady_clock;
+
+struct Client {};
+
+class Object : public OHOS::RefBase {};
+
+struct ObjectId {
+    ObjectId(Client *client, uint32_t id) : client(client), id(id) {}
+    bool operator<(const ObjectId &other) const
+    {
+        if (client != other.client) {
+            return client < other.client;
+        }
+        return id < other.id;
+    }
+
+    Client *client = nullptr;
+    uint32_t id = 0;
+};
+
+// the old WaylandObjectsPool.
+class MapPool {
+public:
+    void AddObject(ObjectId id, const OHOS::sptr<Object> &object)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        objects_[id] = object;
+    }
+
+    void RemoveObject(ObjectId id, const OHOS::sptr<Object> &object)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (objects_.count(id) == 0 || objects_.at(id) != object) {
+            return;
+        }
+        objects_.erase(id);
+    }
+
+    OHOS::sptr<Object> GetObject(ObjectId id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (objects_.count(id) == 0) {
+            return nullptr;
+        }
+        return objects_.at(id);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<ObjectId, OHOS::sptr<Object>> objects_;
+};
+
+// the WaylandObjectsPool now, @inLoop stands for InDisplayLoop().
+class ClientTablePool {
+public:
+    void AddObject(ObjectId id, const OHOS::sptr<Object> &object)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto objInPool = FindObject(id);
+        if (objInPool != nullptr) {
+            *objInPool = object;
+            return;
+        }
+        auto &objects = clients_[id.client];
+        if (id.id < SERVER_ID_START && id.id < objects.denseObjects.size() + MAX_DENSE_ID_GAP) {
+            if (id.id >= objects.denseObjects.size()) {
+                objects.denseObjects.resize(id.id + 1);
+            }
+            objects.denseObjects[id.id] = object;
+        } else {
+            objects.sparseObjects[id.id] = object;
+        }
+        ++objects.count;
+    }
+
+    void RemoveObject(ObjectId id, const OHOS::sptr<Object> &object)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto objInPool = FindObject(id);
+        if (objInPool == nullptr || *objInPool != object) {
+            return;
+        }
+        auto clientIter = clients_.find(id.client);
+        auto &objects = clientIter->second;
+        if (id.id < objects.denseObjects.size() && objects.denseObjects[id.id] == object) {
+            objects.denseObjects[id.id] = nullptr;
+        } else {
+            objects.sparseObjects.erase(id.id);
+        }
+        if (--objects.count == 0) {
+            clients_.erase(clientIter);
+        }
+    }
+
+    OHOS::sptr<Object> GetObject(ObjectId id, bool inLoop) const
+    {
+        std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+        if (!inLoop) {
+            lock.lock();
+        }
+        auto objInPool = FindObject(id);
+        return objInPool == nullptr ? nullptr : *objInPool;
+    }
+
+private:
+    struct ClientObjects {
+        std::vector<OHOS::sptr<Object>> denseObjects;
+        std::unordered_map<uint32_t, OHOS::sptr<Object>> sparseObjects;
+        size_t count = 0;
+    };
+
+    const OHOS::sptr<Object> *FindObject(const ObjectId &id) const
+    {
+        auto clientIter = clients_.find(id.client);
+        if (clientIter == clients_.end()) {
+            return nullptr;
+        }
+        const auto &objects = clientIter->second;
+        if (id.id < objects.denseObjects.size() && objects.denseObjects[id.id] != nullptr) {
+            return &objects.denseObjects[id.id];
+        }
+        if (objects.sparseObjects.empty()) {
+            return nullptr;
+        }
+        auto iter = objects.sparseObjects.find(id.id);
+        return iter == objects.sparseObjects.end() ? nullptr : &iter->second;
+    }
+
+    OHOS::sptr<Object> *FindObject(const ObjectId &id)
+    {
+        return const_cast<OHOS::sptr<Object> *>(std::as_const(*this).FindObject(id));
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Client *, ClientObjects> clients_;
+};
+
+struct Entry {
+    ObjectId id;
+    OHOS::sptr<Object> object;
+};
+
+// the objects of every client, the ids allocated by libwayland from 2 on (1 is the wl_display).
+std::vector<Entry> MakeEntries(std::vector<Client> &clients)
+{
+    std::vector<Entry> entries;
+    for (auto &client : clients) {
+        for (int i = 0; i < OBJECTS_PER_CLIENT - SERVER_OBJECTS_PER_CLIENT; ++i) {
+            entries.push_back({ObjectId(&client, static_cast<uint32_t>(i + 2)), new Object()});
+        }
+        for (int i = 0; i < SERVER_OBJECTS_PER_CLIENT; ++i) {
+            entries.push_back({ObjectId(&client, SERVER_ID_START + static_cast<uint32_t>(i)), new Object()});
+        }
+    }
+    return entries;
+}
+
+// the lookups come from the requests of the clients, take them in a shuffled order.
+std::vector<std::size_t> MakeLookupOrder(std::size_t count)
+{
+    std::vector<std::size_t> order(count);
+    uint32_t seed = 1;
+    for (auto &index : order) {
+        seed = seed * 1664525 + 1013904223; // LCG, deterministic between the runs.
+        index = seed % count;
+    }
+    return order;
+}
+
+template <typename Func>
+double NanosPerCall(int calls, Func func)
+{
+    auto start = Clock::now();
+    func();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+}
+
+template <typename Pool, typename Get>
+void Measure(const char *name, std::vector<Entry> &entries, const std::vector<std::size_t> &order, Get get)
+{
+    Pool pool;
+    int count = static_cast<int>(entries.size());
+    double add = NanosPerCall(count, [&] {
+        for (auto &entry : entries) {
+            pool.AddObject(entry.id, entry.object);
+        }
+    });
+    std::size_t found = 0;
+    double loopGet = NanosPerCall(LOOKUPS, [&] {
+        for (int i = 0; i < LOOKUPS; ++i) {
+            const auto &entry = entries[order[static_cast<std::size_t>(i) % order.size()]];
+            found += get(pool, entry.id, true) != nullptr;
+        }
+    });
+    double lockedGet = NanosPerCall(LOOKUPS, [&] {
+        for (int i = 0; i < LOOKUPS; ++i) {
+            const auto &entry = entries[order[static_cast<std::size_t>(i) % order.size()]];
+            found += get(pool, entry.id, false) != nullptr;
+        }
+    });
+    double remove = NanosPerCall(count, [&] {
+        for (auto &entry : entries) {
+            pool.RemoveObject(entry.id, entry.object);
+        }
+    });
+    std::printf("%14s %10.1f %10.1f %12.1f %10.1f %10zu\n", name, add, loopGet, lockedGet, remove, found);
+}
+} // namespace
+
+int main()
+{
+    std::vector<Client> clients(CLIENTS);
+    std::vector<Entry> entries = MakeEntries(clients);
+    std::vector<std::size_t> order = MakeLookupOrder(entries.size());
+    std::printf("objects_pool_benchmark: %zu objects across %d clients, %d lookups\n", entries.size(), CLIENTS,
+        LOOKUPS);
+    std::printf("%14s %10s %10s %12s %10s %10s\n", "pool", "add ns", "get ns", "locked get", "remove ns",
+        "found");
+    Measure<MapPool>("map + mutex", entries, order,
+        [](const MapPool &pool, ObjectId id, bool) { return pool.GetObject(id); });
+    Measure<ClientTablePool>("client tables", entries, order,
+        [](const ClientTablePool &pool, ObjectId id, bool inLoop) { return pool.GetObject(id, inLoop); });
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2023 Huawei Technologies Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Microbenchmark of the fan-out of an input event to the seat objects of its client, as done by
+// WaylandSeat: the old path, which took the seat mutex and copied the client's lists of seat, pointer and
+// keyboard sptrs for every event, against the per-client cache of raw pointers which GetInputTargets
+// keeps now. The seat objects are modelled by plain RefBase classes with the same containers, a real
+// WaylandSeat needs a display and bound clients. Counts the allocations per event too.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "refbase.h"
+
+namespace {
+constexpr int CLIENTS = 100;
+constexpr int SEATS_PER_CLIENT[] = {1, 2};
+constexpr int EVENTS = 1000000;
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<uint64_t> g_allocs{0};
+
+struct Client {};
+
+class Pointer : public OHOS::RefBase {
+public:
+    void OnPointerMotion(uint64_t &sink) const
+    {
+        sink += reinterpret_cast<uintptr_t>(this) & 0xff;
+    }
+};
+
+class Keyboard : public OHOS::RefBase {};
+
+struct InputTargets {
+    std::vector<Pointer *> pointers;
+    std::vector<Keyboard *> keyboards;
+};
+
+// WaylandSeatObject: its pointers and keyboards, keyed by the client like the real one.
+class SeatObject : public OHOS::RefBase {
+public:
+    explicit SeatObject(Client *client) : client_(client)
+    {
+        pointerResourcesMap_[client].emplace_back(new Pointer());
+        keyboardResourcesMap_[client].emplace_back(new Keyboard());
+    }
+
+    void GetChildPointer(std::list<OHOS::sptr<Pointer>> &list)
+    {
+        auto iter = pointerResourcesMap_.find(client_);
+        if (iter == pointerResourcesMap_.end()) {
+            return;
+        }
+        list = iter->second;
+    }
+
+    void CollectInputTargets(InputTargets &targets) const
+    {
+        auto pointerIter = pointerResourcesMap_.find(client_);
+        if (pointerIter != pointerResourcesMap_.end()) {
+            for (auto &pointer : pointerIter->second) {
+                targets.pointers.emplace_back(pointer.GetRefPtr());
+            }
+        }
+        auto keyboardIter = keyboardResourcesMap_.find(client_);
+        if (keyboardIter != keyboardResourcesMap_.end()) {
+            for (auto &keyboard : keyboardIter->second) {
+                targets.keyboards.emplace_back(keyboard.GetRefPtr());
+            }
+        }
+    }
+
+private:
+    Client *client_ = nullptr;
+    std::unordered_map<Client *, std::list<OHOS::sptr<Pointer>>> pointerResourcesMap_;
+    std::unordered_map<Client *, std::list<OHOS::sptr<Keyboard>>> keyboardResourcesMap_;
+};
+
+// WaylandSeat's seat objects and both lookups of its pointers.
+class Seat {
+public:
+    void Bind(Client *client)
+    {
+        std::lock_guard<std::mutex> lock(seatResourcesMutex_);
+        seatResourcesMap_[client].emplace_back(new SeatObject(client));
+        inputTargets_.erase(client);
+    }
+
+    // the old GetPointerResource.
+    void GetPointerResource(Client *client, std::list<OHOS::sptr<Pointer>> &list)
+    {
+        std::lock_guard<std::mutex> lock(seatResourcesMutex_);
+        auto iter = seatResourcesMap_.find(client);
+        if (iter == seatResourcesMap_.end()) {
+            return;
+        }
+        auto seatList = iter->second;
+        for (auto &seatResourceItem : seatList) {
+            std::list<OHOS::sptr<Pointer>> pointerList;
+            seatResourceItem->GetChildPointer(pointerList);
+            for (auto &pointerResourceItem : pointerList) {
+                list.emplace_back(pointerResourceItem);
+            }
+        }
+    }
+
+    const InputTargets &GetInputTargets(Client *client)
+    {
+        auto cached = inputTargets_.find(client);
+        if (cached != inputTargets_.end()) {
+            return cached->second;
+        }
+        static const InputTargets emptyTargets;
+        std::lock_guard<std::mutex> lock(seatResourcesMutex_);
+        auto iter = seatResourcesMap_.find(client);
+        if (iter == seatResourcesMap_.end()) {
+            return emptyTargets;
+        }
+        auto &targets = inputTargets_[client];
+        for (auto &seatResourceItem : iter->second) {
+            seatResourceItem->CollectInputTargets(targets);
+        }
+        return targets;
+    }
+
+private:
+    std::unordered_map<Client *, std::list<OHOS::sptr<SeatObject>>> seatResourcesMap_;
+    std::mutex seatResourcesMutex_;
+    std::unordered_map<Client *, InputTargets> inputTargets_;
+};
+
+template <typename FanOut>
+void Measure(const char *name, int seatsPerClient, std::vector<Client> &clients, FanOut fanOut)
+{
+    uint64_t sink = 0;
+    uint64_t allocs = g_allocs.load();
+    auto start = Clock::now();
+    for (int i = 0; i < EVENTS; ++i) {
+        fanOut(&clients[static_cast<std::size_t>(i % CLIENTS)], sink);
+    }
+    double nanos = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    double allocsPerEvent = static_cast<double>(g_allocs.load() - allocs) / EVENTS;
+    std::printf("%16s %8d %12.1f %14.2f %12lu\n", name, seatsPerClient, nanos / EVENTS, allocsPerEvent,
+        static_cast<unsigned long>(sink & 0xffff));
+}
+} // namespace
+
+// the default operator delete frees with std::free too.
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+int main()
+{
+    std::printf("seat_input_targets_benchmark: %d clients, %d pointer events\n", CLIENTS, EVENTS);
+    std::printf("%16s %8s %12s %14s %12s\n", "path", "seats", "ns/event", "allocs/event", "checksum");
+    for (int seatsPerClient : SEATS_PER_CLIENT) {
+        std::vector<Client> clients(CLIENTS);
+        Seat seat;
+        for (auto &client : clients) {
+            for (int i = 0; i < seatsPerClient; ++i) {
+                seat.Bind(&client);
+            }
+        }
+        Measure("copied lists", seatsPerClient, clients, [&seat](Client *client, uint64_t &sink) {
+            std::list<OHOS::sptr<Pointer>> pointers;
+            seat.GetPointerResource(client, pointers);
+            for (auto &pointer : pointers) {
+                pointer->OnPointerMotion(sink);
+            }
+        });
+        Measure("cached targets", seatsPerClient, clients, [&seat](Client *client, uint64_t &sink) {
+            for (auto pointer : seat.GetInputTargets(client).pointers) {
+                pointer->OnPointerMotion(sink);
+            }
+        });
+    }
+    return EXIT_SUCCESS;
+}
@@ -15,6 +15,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
+#include "wayland-server-core.h"
 #include "wayland_singleton.h"
 #include "event_loop.h"
 
@@ -26,18 +30,52 @@ class WaylandEventLoop : public Singleton<WaylandEventLoop> {
 
 public:
     void Start();
-    void QueueToLoop(Functor func);
+    void QueueToLoop(Functor func, FunctorPriority priority = FunctorPriority::PROTOCOL);
     template <typename Task, typename Ret = std::invoke_result_t<Task>>
-    std::future<Ret> Schedule(Task task)
+    LoopFuture<Ret> Schedule(Task task)
     {
-        return loop_->Schedule(task);
+        return loop_->Schedule(std::move(task));
     }
     EventLoop *GetEventLoopPtr();
+    // run @task when the display loop is idle, or after @deadline micro seconds at the latest.
+    void RunWhenIdle(Functor task, TimeType deadline = 0);
+    // CLOCK_MONOTONIC milliseconds of the display loop's clock, for the timestamps sent to the clients.
+    uint32_t NowMillis() const;
+
+    // The output to the clients is flushed once per iteration of the display loop, before it sleeps,
+    // instead of after every event: the code sending events out of a display dispatch calls ScheduleFlush.
+    // wl_display_flush_clients only writes to the clients with buffered output.
+    // @display: the display whose clients are flushed, null to stop flushing. display loop thread only.
+    void SetFlushDisplay(struct wl_display *display);
+    // display loop thread only.
+    void ScheduleFlush()
+    {
+        flushPending_ = true;
+        flushRequests_.store(flushRequests_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // append the latency stats of the display loop to @out, for the SA dump.
+    void DumpLoopStats(std::string &out) const;
+    void ResetLoopStats();
+
     WaylandEventLoop();
     ~WaylandEventLoop() noexcept;
 
 private:
+    void FlushClients();
+    void DumpFlushStats(std::string &out) const;
+
     std::shared_ptr<EventLoop> loop_ = nullptr;
+
+    struct wl_display *flushDisplay_ = nullptr; // only touched in the display loop.
+    bool flushPending_ = false;
+    // written by the display loop only, read by the dump.
+    std::atomic<uint64_t> flushRequests_{0};
+    std::atomic<uint64_t> flushes_{0};
+    // the flushes per second are counted from the previous dump.
+    mutable std::mutex flushDumpMutex_;
+    mutable uint64_t lastDumpFlushes_ = 0;
+    mutable TimeStamp lastDumpTime_;
 };
 } // namespace Wayland
 } // namespace FT
@@ -15,8 +15,13 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace FT {
 namespace Wayland {
+    // MMI key code to linux key code, -1 if unknown.
     int32_t TransferKeyValue(int32_t keyValueOfInput);
+    // linux key code to MMI key code, KeyEvent::KEYCODE_UNKNOWN if unknown.
+    int32_t TransferLinuxKeyValue(int32_t keyValueOfLinux);
 } // namespace Wayland
 } // namespace FT
@@ -15,9 +15,11 @@
 
 #pragma once
 
-#include <map>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
+#include "event_loop.h"
 #include "wayland_singleton.h"
 #include "wayland_resource_object.h"
 
@@ -28,22 +30,45 @@ public:
     virtual void OnDestroy(ObjectId objectId) {}
 };
 
+// The objects are kept in one table per client, indexed by the protocol id. Objects are only created
+// and destroyed in the display loop, as libwayland requires, and AddObject/RemoveObject assert it:
+// the display loop is the only writer, so it looks the objects up without locking, and the mutex
+// only keeps the lookups of the other threads away from the changes.
 class WaylandObjectsPool : public Singleton<WaylandObjectsPool> {
     DECLARE_SINGLETON(WaylandObjectsPool)
 
 public:
     static void SetCallback(OHOS::sptr<WaylandObjectsPoolCallback> cb);
+    // @loop: the display loop, the only thread allowed to add and remove objects.
+    // Must be set before the first object is added, and not changed while the loop runs.
+    void SetDisplayLoop(EventLoop *loop);
     void AddObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object);
     void RemoveObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object);
     OHOS::sptr<WaylandResourceObject> GetObject(ObjectId id) const;
+    // whether @object is the one in the pool with @id, without taking a reference on it.
+    bool ContainsObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object) const;
 
 private:
-    WaylandObjectsPool() = default;
+    WaylandObjectsPool();
     ~WaylandObjectsPool() noexcept override = default;
 
+    // the objects of one client: the ids allocated by the client are dense and reused by libwayland,
+    // they index a vector; the ids allocated by the server, or far beyond the others, go to a hash map.
+    struct ClientObjects {
+        std::vector<OHOS::sptr<WaylandResourceObject>> denseObjects;
+        std::unordered_map<uint32_t, OHOS::sptr<WaylandResourceObject>> sparseObjects;
+        size_t count = 0;
+    };
+
+    bool InDisplayLoop() const;
+    void AssertInDisplayLoop() const;
+    const OHOS::sptr<WaylandResourceObject> *FindObject(const ObjectId &id) const;
+    OHOS::sptr<WaylandResourceObject> *FindObject(const ObjectId &id);
+
     static OHOS::sptr<WaylandObjectsPoolCallback> cb_;
+    EventLoop *displayLoop_ = nullptr;
     mutable std::mutex mutex_;
-    std::map<ObjectId, OHOS::sptr<WaylandResourceObject>> objects_;
+    std::unordered_map<struct wl_client *, ClientObjects> clients_;
 };
 } // namespace Wayland
 } // namespace FT
@@ -15,12 +15,71 @@
 
 #include "wayland_event_loop.h"
 
+#include <cstdlib>
+
+#include "thread_options.h"
+#include "wayland_adapter_hilog.h"
+
+// set by the GN args ft_display_thread_cpus and ft_display_thread_priority, see config.gni.
+#ifndef DISPLAY_THREAD_CPUS
+#define DISPLAY_THREAD_CPUS ""
+#endif
+#ifndef DISPLAY_THREAD_PRIORITY
+#define DISPLAY_THREAD_PRIORITY 0
+#endif
+
 namespace FT {
 namespace Wayland {
+namespace {
+    constexpr HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WAYLAND, "WaylandEventLoop"};
+#ifdef ENABLE_LOOP_WATCHDOG
+    // an iteration of the display loop longer than this freezes every client visibly.
+    constexpr TimeType DISPLAY_LOOP_STALL_BUDGET = 100 * 1000; // 100ms
+#endif
+    constexpr const char *DISPLAY_THREAD_NAME = "WaylandDisplay";
+
+    // @cpus: comma separated cpu numbers, the invalid ones are logged and skipped.
+    ThreadOptions DisplayThreadOptions(const char *cpus, int priority)
+    {
+        ThreadOptions options;
+        const char *pos = cpus;
+        while (*pos != '\0') {
+            char *end = nullptr;
+            long cpu = std::strtol(pos, &end, 10);
+            if (end == pos || cpu < 0 || (*end != ',' && *end != '\0')) {
+                LOG_ERROR("Invalid display thread cpus: %{public}s", cpus);
+                return DisplayThreadOptions("", priority);
+            }
+            options.cpus.emplace_back(static_cast<int>(cpu));
+            pos = *end == ',' ? end + 1 : end;
+        }
+        if (priority > 0) {
+            options.policy = SchedPolicy::FIFO;
+            options.priority = priority;
+        }
+        return options;
+    }
+
+    void DumpTimerStats(const EventLoop &loop, std::string &out)
+    {
+        TimerStats stats = loop.GetTimerStats();
+        AppendFormat(out, "  timer wakeups: %lu, rearms: %lu, rearms skipped: %lu, wakeups saved: %lu\n",
+            stats.wakeups, stats.rearms, stats.rearmsSkipped, stats.wakeupsSaved);
+    }
+}
 
 WaylandEventLoop::WaylandEventLoop()
 {
-    loop_ = std::make_shared<EventLoop>();
+    // the display loop runs in the thread which constructs it, so set that thread up first.
+    ApplyThreadOptions(DISPLAY_THREAD_NAME, DisplayThreadOptions(DISPLAY_THREAD_CPUS, DISPLAY_THREAD_PRIORITY));
+    EventLoopOptions options;
+#ifdef ENABLE_LOOP_WATCHDOG
+    // debug only, the watchdog adds a thread and interrupts the display thread to sample its stack.
+    options.stallBudget = DISPLAY_LOOP_STALL_BUDGET;
+#endif
+    loop_ = std::make_shared<EventLoop>(options);
+    loop_->AddPreSleepHook([this]() { FlushClients(); });
+    lastDumpTime_ = TimeStamp::Now();
 }
 
 WaylandEventLoop::~WaylandEventLoop()
@@ -28,13 +87,27 @@ WaylandEventLoop::~WaylandEventLoop()
     loop_ = nullptr;
 }
 
-void WaylandEventLoop::QueueToLoop(Functor func)
+void WaylandEventLoop::QueueToLoop(Functor func, FunctorPriority priority)
 {
     if (loop_) {
-        loop_->QueueToLoop(func);
+        loop_->QueueToLoop(std::move(func), priority);
     }
 }
 
+void WaylandEventLoop::RunWhenIdle(Functor task, TimeType deadline)
+{
+    if (loop_) {
+        loop_->RunWhenIdle(std::move(task), deadline);
+    }
+}
+
+uint32_t WaylandEventLoop::NowMillis() const
+{
+    TimeStamp now = loop_ ? loop_->Now() : TimeStamp::Now();
+    // the protocol's timestamps wrap around.
+    return static_cast<uint32_t>(TimeDiff(now, TimeStamp::SystemStartTime()) / MICRO_SECS_PER_MILLISECOND);
+}
+
 EventLoop *WaylandEventLoop::GetEventLoopPtr()
 {
     if (loop_) {
@@ -43,6 +116,57 @@ EventLoop *WaylandEventLoop::GetEventLoopPtr()
     return nullptr;
 }
 
+void WaylandEventLoop::SetFlushDisplay(struct wl_display *display)
+{
+    flushDisplay_ = display;
+    flushPending_ = false;
+}
+
+void WaylandEventLoop::FlushClients()
+{
+    if (!flushPending_ || flushDisplay_ == nullptr) {
+        return;
+    }
+
+    flushPending_ = false;
+    wl_display_flush_clients(flushDisplay_);
+    flushes_.store(flushes_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void WaylandEventLoop::DumpFlushStats(std::string &out) const
+{
+    uint64_t requests = flushRequests_.load(std::memory_order_relaxed);
+    uint64_t flushes = flushes_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(flushDumpMutex_);
+    TimeStamp now = TimeStamp::Now();
+    TimeType elapsed = TimeDiff(now, lastDumpTime_);
+    uint64_t perSecond = elapsed > 0 ?
+        (flushes - lastDumpFlushes_) * MICRO_SECS_PER_SECOND / static_cast<uint64_t>(elapsed) : 0;
+    lastDumpFlushes_ = flushes;
+    lastDumpTime_ = now;
+    AppendFormat(out, "  client flushes: %lu for %lu requests, %lu per second since the last dump\n",
+        flushes, requests, perSecond);
+}
+
+void WaylandEventLoop::DumpLoopStats(std::string &out) const
+{
+    if (loop_) {
+        out += "WaylandDisplay loop:\n";
+        loop_->GetLoopStats().Dump(out);
+        DumpTimerStats(*loop_, out);
+        DumpFlushStats(out);
+        loop_->DumpStallStats(out);
+    }
+}
+
+void WaylandEventLoop::ResetLoopStats()
+{
+    if (loop_) {
+        loop_->ResetLoopStats();
+    }
+}
+
 void WaylandEventLoop::Start()
 {
     if (loop_) {
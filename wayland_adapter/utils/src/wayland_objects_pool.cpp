@@ -15,10 +15,15 @@
 
 #include "wayland_objects_pool.h"
 
+#include <cstdlib>
+#include <utility>
+
 namespace FT {
 namespace Wayland {
 namespace {
     constexpr HiLogLabel LABEL = {LOG_CORE, HILOG_DOMAIN_WAYLAND, "WaylandObjectsPool"};
+    constexpr uint32_t SERVER_ID_START = 0xff000000; // WL_SERVER_ID_START of libwayland.
+    constexpr uint32_t MAX_DENSE_ID_GAP = 1024;      // how far beyond the dense ids a new id may still go.
 }
 
 OHOS::sptr<WaylandObjectsPoolCallback> WaylandObjectsPool::cb_ = nullptr;
@@ -27,31 +32,99 @@ void WaylandObjectsPool::SetCallback(OHOS::sptr<WaylandObjectsPoolCallback> cb)
     cb_ = cb;
 }
 
+WaylandObjectsPool::WaylandObjectsPool() = default;
+
+void WaylandObjectsPool::SetDisplayLoop(EventLoop *loop)
+{
+    displayLoop_ = loop;
+}
+
+bool WaylandObjectsPool::InDisplayLoop() const
+{
+    return displayLoop_ != nullptr && EventLoop::EventLoopOfCurrThread() == displayLoop_;
+}
+
+// the display loop is the only writer, which is what lets it read without locking.
+void WaylandObjectsPool::AssertInDisplayLoop() const
+{
+    if (!InDisplayLoop()) {
+        LOG_ERROR("objects must be added and removed in the display loop(%{public}p)!", displayLoop_);
+        std::abort();
+    }
+}
+
+const OHOS::sptr<WaylandResourceObject> *WaylandObjectsPool::FindObject(const ObjectId &id) const
+{
+    auto clientIter = clients_.find(id.client);
+    if (clientIter == clients_.end()) {
+        return nullptr;
+    }
+
+    const auto &objects = clientIter->second;
+    if (id.id < objects.denseObjects.size() && objects.denseObjects[id.id] != nullptr) {
+        return &objects.denseObjects[id.id];
+    }
+    if (objects.sparseObjects.empty()) {
+        return nullptr;
+    }
+    auto iter = objects.sparseObjects.find(id.id);
+    return iter == objects.sparseObjects.end() ? nullptr : &iter->second;
+}
+
+OHOS::sptr<WaylandResourceObject> *WaylandObjectsPool::FindObject(const ObjectId &id)
+{
+    return const_cast<OHOS::sptr<WaylandResourceObject> *>(std::as_const(*this).FindObject(id));
+}
+
 void WaylandObjectsPool::AddObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object)
 {
+    AssertInDisplayLoop();
     std::lock_guard<std::mutex> lock(mutex_);
-    if (objects_.count(id) > 0) {
+    auto objInPool = FindObject(id);
+    if (objInPool != nullptr) {
         LOG_WARN("object already exists");
+        *objInPool = object;
+        return;
     }
 
-    objects_[id] = object;
+    auto &objects = clients_[id.client];
+    if (id.id < SERVER_ID_START && id.id < objects.denseObjects.size() + MAX_DENSE_ID_GAP) {
+        if (id.id >= objects.denseObjects.size()) {
+            objects.denseObjects.resize(id.id + 1);
+        }
+        objects.denseObjects[id.id] = object;
+    } else {
+        objects.sparseObjects[id.id] = object;
+    }
+    ++objects.count;
 }
 
 void WaylandObjectsPool::RemoveObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object)
 {
+    AssertInDisplayLoop();
     std::lock_guard<std::mutex> lock(mutex_);
-    if (objects_.count(id) == 0) {
+    auto objInPool = FindObject(id);
+    if (objInPool == nullptr) {
         LOG_WARN("object already removed");
         return;
     }
 
-    const auto &objInPool = objects_.at(id);
-    if (objInPool != object) {
+    if (*objInPool != object) {
         LOG_ERROR("invalid id");
         return;
     }
 
-    objects_.erase(id);
+    auto clientIter = clients_.find(id.client);
+    auto &objects = clientIter->second;
+    if (id.id < objects.denseObjects.size() && objects.denseObjects[id.id] == object) {
+        objects.denseObjects[id.id] = nullptr;
+    } else {
+        objects.sparseObjects.erase(id.id);
+    }
+    // a new client may get the same wl_client address, and the client's objects are gone with it.
+    if (--objects.count == 0) {
+        clients_.erase(clientIter);
+    }
 
     if (cb_ != nullptr) {
         cb_->OnDestroy(id);
@@ -60,13 +133,27 @@ void WaylandObjectsPool::RemoveObject(ObjectId id, const OHOS::sptr<WaylandResou
 
 OHOS::sptr<WaylandResourceObject> WaylandObjectsPool::GetObject(ObjectId id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (objects_.count(id) == 0) {
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (!InDisplayLoop()) {
+        lock.lock();
+    }
+    auto objInPool = FindObject(id);
+    if (objInPool == nullptr) {
         LOG_WARN("object does not exist");
         return nullptr;
     }
 
-    return objects_.at(id);
+    return *objInPool;
+}
+
+bool WaylandObjectsPool::ContainsObject(ObjectId id, const OHOS::sptr<WaylandResourceObject> &object) const
+{
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (!InDisplayLoop()) {
+        lock.lock();
+    }
+    auto objInPool = FindObject(id);
+    return objInPool != nullptr && *objInPool == object;
 }
 } // namespace Wayland
 } // namespace FT
@@ -84,8 +84,7 @@ bool WaylandResourceObject::CheckIfObjectIsValid(const OHOS::sptr<WaylandResourc
     }
 
     auto objId = ObjectId(object->WlClient(), object->Id());
-    auto objInPool = WaylandObjectsPool::GetInstance().GetObject(objId);
-    if (objInPool != object) {
+    if (!WaylandObjectsPool::GetInstance().ContainsObject(objId, object)) {
         LOG_ERROR("CheckIfObjectIsValid failed");
         return false;
     }
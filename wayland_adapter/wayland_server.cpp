@@ -15,9 +15,12 @@
 
 #include "wayland_server.h"
 
+#include <cstdio>
 #include <system_ability_definition.h>
 #include "wayland_adapter_hilog.h"
 #include "wayland_event_loop.h"
+#include "wayland_objects_pool.h"
+#include "wayland_surface.h"
 
 namespace FT {
 namespace Wayland {
@@ -74,12 +77,16 @@ void WaylandServer::OnStart()
         return;
     }
 
+    // the objects of the clients are only created and destroyed in the display loop.
+    WaylandObjectsPool::GetInstance().SetDisplayLoop(WaylandEventLoop::GetInstance().GetEventLoopPtr());
     CreateGlobalObjects();
     wlDisplayChannel_ = std::make_unique<EventChannel>(wl_event_loop_get_fd(wlDisplayLoop_),
         WaylandEventLoop::GetInstance().GetEventLoopPtr());
+    // the requests may send events to any client, so flush them all before the loop sleeps.
+    WaylandEventLoop::GetInstance().SetFlushDisplay(display_);
     wlDisplayChannel_->SetReadCallback([this](TimeStamp timeStamp) {
         wl_event_loop_dispatch(wlDisplayLoop_, -1);
-        wl_display_flush_clients(display_);
+        WaylandEventLoop::GetInstance().ScheduleFlush();
     });
     wlDisplayChannel_->EnableReading(true);
     WaylandEventLoop::GetInstance().Start();
@@ -94,6 +101,7 @@ void WaylandServer::OnStop()
     }
 
     auto stopWlDisplay = WaylandEventLoop::GetInstance().Schedule([this]() {
+        WaylandEventLoop::GetInstance().SetFlushDisplay(nullptr);
         wl_display_terminate(display_);
         wl_display_destroy_clients(display_);
         wl_display_destroy(display_);
@@ -102,7 +110,7 @@ void WaylandServer::OnStop()
             wlDisplayChannel_ = nullptr;
         }
     });
-    stopWlDisplay.wait();
+    stopWlDisplay.Wait();
 
     display_ = nullptr;
     compositorGlobal_ = nullptr;
@@ -120,6 +128,29 @@ void WaylandServer::OnAddSystemAbility(int32_t systemAbilityId, const std::strin
     LOG_INFO("systemAbilityId: %{public}d, start", systemAbilityId);
 }
 
+int32_t WaylandServer::Dump(int32_t fd, const std::vector<std::u16string> &args)
+{
+    std::string out;
+    if (!args.empty() && args[0] == u"-h") {
+        out = "Usage:\n"
+              "  -h: show this help.\n"
+              "  -r: reset the latency stats of the event loops.\n"
+              "  no option: dump the latency stats of the event loops.\n";
+    } else if (!args.empty() && args[0] == u"-r") {
+        WaylandEventLoop::GetInstance().ResetLoopStats();
+        out = "Latency stats reset.\n";
+    } else {
+        WaylandEventLoop::GetInstance().DumpLoopStats(out);
+        WaylandSurface::DumpInputStats(out);
+    }
+
+    if (dprintf(fd, "%s", out.c_str()) < 0) {
+        LOG_ERROR("Dump to fd %{public}d failed", fd);
+        return -1;
+    }
+    return 0;
+}
+
 std::string WaylandServer::GetClassName()
 {
     return "WaylandServer";
@@ -44,6 +44,7 @@ public:
     void OnStart() override;
     void OnStop() override;
     void OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
+    int32_t Dump(int32_t fd, const std::vector<std::u16string> &args) override;
     std::string GetClassName() override;
 
 private: